@@ -0,0 +1,13 @@
+meta:
+	ADDON_NAME = ofxDarkKnight
+	ADDON_DESCRIPTION = Node based programming environment for openframeworks
+	ADDON_URL = https://github.com/luiscript/ofxDarkKnight
+
+# the noise, lfo and particle batches have AVX2 paths, the binary then needs
+# a Haswell or newer cpu. osx is left out, x86 builds also run under Rosetta
+# which has no AVX2. arm builds take the NEON paths without extra flags.
+linux64:
+	ADDON_CFLAGS += -mavx2
+
+vs:
+	ADDON_CFLAGS += /arch:AVX2
@@ -1,14 +1,11 @@
-#version 120
-#extension GL_ARB_texture_rectangle : enable
-
-uniform sampler2DRect tex1;
+uniform SAMPLER_TYPE tex1;
 uniform float mixer;
 
 void main()
 {
     vec2 st = gl_TexCoord[0].st;
-    vec4 tp = texture2DRect(tex1, st);
+    vec4 tp = TEXTURE_FN(tex1, st);
     vec3 inv = vec3(1.0 - tp.r, 1.0 - tp.g, 1.0 - tp.b);
     vec3 color = mix(tp.rgb, inv, mixer);
-    gl_FragColor = vec4(1.0, 1.0);
+    gl_FragColor = vec4(color, tp.a);
 }
\ No newline at end of file
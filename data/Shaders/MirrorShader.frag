@@ -1,8 +1,5 @@
-#version 120
-#extension GL_ARB_texture_rectangle : enable
-
 uniform vec2 resolution;
-uniform sampler2DRect tex;
+uniform SAMPLER_TYPE tex;
 uniform float vertical;
 uniform float horizontal;
 
@@ -16,5 +13,5 @@ void main() {
 		normSrcCoord.y = (resolution.y-normSrcCoord.y);
 	}
 	
-	gl_FragColor = texture2DRect(tex, normSrcCoord);
+	gl_FragColor = TEXTURE_FN(tex, normSrcCoord);
 }
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "ofMain.h"
+#include "ofApp.h"
+
+//========================================================================
+int main( ){
+    ofGLFWWindowSettings settings;
+    settings.resizable = true;
+    settings.setSize(1920, 1080);
+    
+    shared_ptr<ofAppBaseWindow> mainWindow = ofCreateWindow(settings);
+
+    shared_ptr<ofApp> mainApp(new ofApp);
+    
+    mainApp->mainWindow = mainWindow;
+    ofRunApp(mainWindow, mainApp);
+    ofRunMainLoop();
+
+}
@@ -0,0 +1,67 @@
+#include "ofApp.h"
+
+// frames run before and while measuring each count
+static const int warmupFrames = 30;
+static const int measuredFrames = 120;
+
+void ofApp::setup()
+{
+    ofSetVerticalSync(false);
+    ofBackground(17,17,17);
+    
+    counts = { 1000, 2000, 5000, 10000, 20000, 30000, 40000, 50000 };
+    constellation.setupModule("CONSTELLATION", { (float) ofGetWidth(), (float) ofGetHeight() });
+    constellation.gui->setVisible(false);
+    
+    start(0);
+}
+
+void ofApp::start(int s)
+{
+    step = s;
+    frame = 0;
+    totalMillis = 0;
+    if (step == 0) results.clear();
+    if (step >= counts.size()) return;
+    
+    // driven like a wire would, through the scale of the 0..50000 count slider
+    constellation.gui->getSlider("count")->setComponentScale(counts[step] / 50000.0);
+}
+
+void ofApp::update()
+{
+    if (step >= counts.size()) return;
+    
+    uint64_t begin = ofGetElapsedTimeMicros();
+    constellation.update();
+    float millis = (ofGetElapsedTimeMicros() - begin) / 1000.0;
+    
+    if (frame >= warmupFrames) totalMillis += millis;
+    frame++;
+    
+    if (frame == warmupFrames + measuredFrames)
+    {
+        string line = ofToString(counts[step]) + " particles: " + ofToString(totalMillis / measuredFrames, 3) + " ms update";
+        ofLogNotice() << line;
+        results.push_back(line);
+        start(step + 1);
+    }
+}
+
+void ofApp::draw()
+{
+    constellation.draw();
+    
+    ofSetColor(255);
+    for (int i = 0; i < results.size(); i++)
+    {
+        ofDrawBitmapStringHighlight(results[i], 20, 30 + i * 22);
+    }
+    string status = step < counts.size() ? "measuring " + ofToString(counts[step]) + " particles" : "done, press space to run again";
+    ofDrawBitmapStringHighlight(status, 20, ofGetHeight() - 20);
+}
+
+void ofApp::keyPressed(int key)
+{
+    if (key == ' ' && step >= counts.size()) start(0);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ofMain.h"
+#include "constellation.h"
+
+// sweeps the constellation particle count and logs the average update time
+// for each count, the particles are drawn too so the draw path is included
+class ofApp : public ofBaseApp{
+
+	public:
+		void setup();
+		void update();
+		void draw();
+		void keyPressed(int key);
+    
+        shared_ptr<ofAppBaseWindow> mainWindow;
+    
+    private:
+        void start(int);
+    
+        Constellation constellation;
+        vector<int> counts;
+        vector<string> results;
+        int step;
+        int frame;
+        float totalMillis;
+};
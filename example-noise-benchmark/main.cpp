@@ -0,0 +1,17 @@
+#include "ofMain.h"
+#include "ofApp.h"
+
+//========================================================================
+int main( ){
+    ofGLFWWindowSettings settings;
+    settings.resizable = true;
+    settings.setSize(800, 400);
+    
+    shared_ptr<ofAppBaseWindow> mainWindow = ofCreateWindow(settings);
+
+    shared_ptr<ofApp> mainApp(new ofApp);
+    
+    ofRunApp(mainWindow, mainApp);
+    ofRunMainLoop();
+
+}
@@ -0,0 +1,108 @@
+#include "ofApp.h"
+
+static const int gridSize = 1024;
+static const int batchSize = 1 << 20;
+static const int repetitions = 5;
+static const float frequency = 0.01;
+
+void ofApp::setup()
+{
+    ofBackground(17,17,17);
+    run();
+}
+
+void ofApp::draw()
+{
+    ofSetColor(255);
+    for (int i = 0; i < results.size(); i++)
+    {
+        ofDrawBitmapString(results[i], 20, 30 + i * 20);
+    }
+    ofDrawBitmapString("press space to run again", 20, ofGetHeight() - 20);
+}
+
+void ofApp::keyPressed(int key)
+{
+    if (key == ' ') run();
+}
+
+void ofApp::run()
+{
+    results.clear();
+    checksum = 0;
+    
+#if defined(__AVX2__)
+    results.push_back("DKNoise batch calls use AVX2");
+#else
+    results.push_back("DKNoise batch calls use the scalar fallback");
+#endif
+    
+    vector<float> out(gridSize * gridSize);
+    vector<float> x(batchSize), y(batchSize), z(batchSize);
+    for (int i = 0; i < batchSize; i++)
+    {
+        x[i] = ofRandom(-100, 100);
+        y[i] = ofRandom(-100, 100);
+        z[i] = ofRandom(-100, 100);
+    }
+    
+    // best of a few runs, the first one also pays for page faults
+    float ofNoiseGrid = FLT_MAX, dkGrid = FLT_MAX;
+    float ofNoiseBatch2 = FLT_MAX, dkBatch2 = FLT_MAX;
+    float ofNoiseBatch3 = FLT_MAX, dkBatch3 = FLT_MAX;
+    
+    for (int k = 0; k < repetitions; k++)
+    {
+        uint64_t start = ofGetElapsedTimeMicros();
+        for (int r = 0; r < gridSize; r++)
+        {
+            for (int c = 0; c < gridSize; c++)
+            {
+                out[r * gridSize + c] = ofSignedNoise(c * frequency, r * frequency);
+            }
+        }
+        ofNoiseGrid = MIN(ofNoiseGrid, (ofGetElapsedTimeMicros() - start) / 1000.0);
+        checksum += out[gridSize + 1];
+        
+        start = ofGetElapsedTimeMicros();
+        DKNoise::grid(DKNoiseType::DK_SIMPLEX, 0, frequency, 0, frequency, gridSize, gridSize, out.data());
+        dkGrid = MIN(dkGrid, (ofGetElapsedTimeMicros() - start) / 1000.0);
+        checksum += out[gridSize + 1];
+        
+        start = ofGetElapsedTimeMicros();
+        for (int i = 0; i < batchSize; i++) out[i] = ofSignedNoise(x[i], y[i]);
+        ofNoiseBatch2 = MIN(ofNoiseBatch2, (ofGetElapsedTimeMicros() - start) / 1000.0);
+        checksum += out[1];
+        
+        start = ofGetElapsedTimeMicros();
+        DKNoise::batch(DKNoiseType::DK_SIMPLEX, x.data(), y.data(), out.data(), batchSize);
+        dkBatch2 = MIN(dkBatch2, (ofGetElapsedTimeMicros() - start) / 1000.0);
+        checksum += out[1];
+        
+        start = ofGetElapsedTimeMicros();
+        for (int i = 0; i < batchSize; i++) out[i] = ofSignedNoise(x[i], y[i], z[i]);
+        ofNoiseBatch3 = MIN(ofNoiseBatch3, (ofGetElapsedTimeMicros() - start) / 1000.0);
+        checksum += out[1];
+        
+        start = ofGetElapsedTimeMicros();
+        DKNoise::batch(DKNoiseType::DK_SIMPLEX, x.data(), y.data(), z.data(), out.data(), batchSize);
+        dkBatch3 = MIN(dkBatch3, (ofGetElapsedTimeMicros() - start) / 1000.0);
+        checksum += out[1];
+    }
+    
+    report("grid 2D " + ofToString(gridSize) + "x" + ofToString(gridSize), ofNoiseGrid, dkGrid, gridSize * gridSize);
+    report("batch 2D", ofNoiseBatch2, dkBatch2, batchSize);
+    report("batch 3D", ofNoiseBatch3, dkBatch3, batchSize);
+    
+    // keeps the loops above from being optimized away
+    ofLogVerbose() << "checksum " << checksum;
+}
+
+void ofApp::report(string name, float ofNoiseMillis, float dkMillis, int samples)
+{
+    string line = name + " (" + ofToString(samples) + " samples): ofNoise " +
+        ofToString(ofNoiseMillis, 2) + " ms, DKNoise " + ofToString(dkMillis, 2) + " ms, " +
+        ofToString(ofNoiseMillis / MAX(dkMillis, 0.001f), 1) + "x";
+    ofLogNotice() << line;
+    results.push_back(line);
+}
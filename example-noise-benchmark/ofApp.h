@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ofMain.h"
+#include "DKNoise.hpp"
+
+// times DKNoise::grid and DKNoise::batch against the same samples taken
+// one by one with ofNoise, results go to the log and the window
+class ofApp : public ofBaseApp{
+
+	public:
+		void setup();
+		void draw();
+		void keyPressed(int key);
+    
+    private:
+        void run();
+        void report(string, float, float, int);
+    
+        vector<string> results;
+        float checksum;
+};
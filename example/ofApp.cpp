@@ -7,7 +7,9 @@ void ofApp::setup()
     ofBackground(17,17,17);
 
     app.moduleList["ABLETON LINK"] = &moduleType<DKAbletonLink>;
+    app.moduleList["ANALYZE"] = &moduleType<DKAnalyze>;
     app.moduleList["CHAIN FX"] = &moduleType<DKChain>;
+    app.moduleList["CROP VIEW"] = &moduleType<DKCrop>;
     app.moduleList["FX AA"] = &moduleType<DKFXAntiAliasing>;
     app.moduleList["FX INVERT"] = &moduleType<DKFXColorInv>;
     app.moduleList["FX MIRROR"] = &moduleType<DKFXMirror>;
@@ -24,6 +26,7 @@ void ofApp::setup()
     app.moduleList["MIDI CONTROL IN"] = &moduleType<DKMidiControlIn>;
     app.moduleList["MIDI CONTROL OUT"] = &moduleType<DKMidiControlOut>;
     app.moduleList["MIXER"] = &moduleType<DKMixer>;
+    app.moduleList["NOISE BANK"] = &moduleType<DKNoiseBank>;
     app.moduleList["OSC RECEIVER"] = &moduleType<DKOscClient>;
     app.moduleList["OSC SENDER"] = &moduleType<DKOscServer>;
     app.moduleList["PERLIN NOISE"] = &moduleType<DKPerlin>;
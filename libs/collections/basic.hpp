@@ -33,8 +33,8 @@ public:
     void setup(){
         setCollectionName("Example");
         
-        addItem(new Terrain, "thumbnails/terrain.jpg", "TERRAIN");
-        addItem(new Constellation, "thumbnails/constellation.jpg", "CONSTELLATION");
+        addItem([]() -> DKModule* { return new Terrain; }, "thumbnails/terrain.jpg", "TERRAIN");
+        addItem([]() -> DKModule* { return new Constellation; }, "thumbnails/constellation.jpg", "CONSTELLATION");
         
         init();
     }
@@ -26,7 +26,7 @@ class DKFXAntiAliasing : public DKModule
 {
 private:
     bool gotChain;
-    ofShader shader;
+    DKShaderVariants shader;
     float mn;
     float mx;
     float mt;
@@ -100,34 +100,22 @@ public:
       }
                                                                           
         );
-        ostringstream oss;
-        oss << "#version 120" << endl;
-        if (true)
-        {
-            oss << "#define SAMPLER_TYPE sampler2DRect" << endl;
-            oss << "#define TEXTURE_FN texture2DRect" << endl;
-            oss << fragShaderSrc;
-        }
-        else
-        {
-            oss << "#define SAMPLER_TYPE sampler2D" << endl;
-            oss << "#define TEXTURE_FN texture2D" << endl;
-            oss << fragShaderSrc;
-        }
-        shader.setupShaderFromSource(GL_FRAGMENT_SHADER, oss.str());
-        shader.linkProgram();
+        shader.setupFromSource(fragShaderSrc);
         addInputConnection(DKConnectionType::DK_CHAIN);
         addChainOutputConnection(DKConnectionType::DK_CHAIN);
     }
     void render(ofFbo& readFbo, ofFbo& writeFbo)
     {
+        // fragment coords map 1:1 to rectangle texels, 2D textures need them normalized
+        glm::vec2 texSize(readFbo.getWidth(), readFbo.getHeight());
+        ofShader& program = shader.get(readFbo);
         writeFbo.begin();
         ofClear(0,0,0,0);
-        shader.begin();
-        shader.setUniformTexture("tDiffuse", readFbo.getTexture(), 1);
-        shader.setUniform2f("resolution", 1.f, 1.f);
+        program.begin();
+        program.setUniformTexture("tDiffuse", readFbo.getTexture(), 1);
+        program.setUniform2f("resolution", DKTexture::getCoordScale(readFbo.getTexture()) / texSize);
         texturedQuad(0,0, getModuleWidth(), getModuleHeight());
-        shader.end();
+        program.end();
         writeFbo.end();
     }
     void texturedQuad(float x, float y, float width, float height, float s = 1, float t = 1)
@@ -28,7 +28,7 @@
 class DKFXColorInv : public DKModule
 {
 private:
-	ofShader shader;
+	DKShaderVariants shader;
 	float mix = 0.0;
 public:
 	void setup()
@@ -39,12 +39,13 @@ public:
 	}
     void render(ofFbo& readFbo, ofFbo& writeFbo)
     {
+        ofShader& program = shader.get(readFbo);
         writeFbo.begin();
-        shader.begin();
-        shader.setUniform1f("mixer", mix);
-        shader.setUniformTexture("tex1", readFbo.getTextureReference(), 1);
+        program.begin();
+        program.setUniform1f("mixer", mix);
+        program.setUniformTexture("tex1", readFbo.getTextureReference(), 1);
         readFbo.draw(0, 0);
-        shader.end();
+        program.end();
         writeFbo.end();
     }
     
@@ -28,7 +28,7 @@ private:
 	float red;
 	float green;
 	float blue;
-    ofShader shader;
+    DKShaderVariants shader;
 public:
     void setup()
     {
@@ -39,14 +39,15 @@ public:
     }
     void render(ofFbo& readFbo, ofFbo& writeFbo)
     {
+        ofShader& program = shader.get(readFbo);
         writeFbo.begin();
         ofClear(0, 0, 0, 0);
-        shader.begin();
-        shader.setUniform1f("r", red);
-        shader.setUniform1f("g", green);
-        shader.setUniform1f("b", blue);
+        program.begin();
+        program.setUniform1f("r", red);
+        program.setUniform1f("g", green);
+        program.setUniform1f("b", blue);
         readFbo.draw(0,0);
-        shader.end();
+        program.end();
         writeFbo.end();
     }
 	void addModuleParameters()
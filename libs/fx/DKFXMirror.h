@@ -28,7 +28,7 @@ private:
     float vertical;
     float horizontal;
     bool gotChain;
-    ofShader shader;
+    DKShaderVariants shader;
     
 public:
     void setup()
@@ -45,15 +45,16 @@ public:
     }
     void render(ofFbo& readFbo, ofFbo& writeFbo)
     {
+        ofShader& program = shader.get(readFbo);
         writeFbo.begin();
         ofClear(0,0,0,0);
-        shader.begin();
-        shader.setUniform2f("resolution", glm::vec2(getModuleWidth(), getModuleHeight()));
-        shader.setUniform1f("vertical", vertical);
-        shader.setUniform1f("horizontal", horizontal);
-        shader.setUniformTexture("tex0", readFbo.getTextureReference(), 1);
+        program.begin();
+        program.setUniform2f("resolution", DKTexture::getCoordScale(readFbo.getTexture()));
+        program.setUniform1f("vertical", vertical);
+        program.setUniform1f("horizontal", horizontal);
+        program.setUniformTexture("tex0", readFbo.getTextureReference(), 1);
         readFbo.draw(0,0);
-        shader.end();
+        program.end();
         writeFbo.end();
     }
 };
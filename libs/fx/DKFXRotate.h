@@ -29,7 +29,7 @@ private:
     float y;
     float z;
     float rotation;
-    ofShader shader;
+    DKShaderVariants shader;
 public:
     void setup()
     {
@@ -42,7 +42,8 @@ public:
         uniform float y;
         uniform float z;
         uniform vec2 u_resolution;
-        uniform sampler2DRect tex1;
+        uniform vec2 u_texSize;
+        uniform SAMPLER_TYPE tex1;
          
         mat2 rotate(float angle){
             return mat2(cos(angle), -sin(angle), sin(angle), cos(angle));
@@ -54,10 +55,10 @@ public:
             vec3 color = vec3(0.0);
             
             coord -= vec2(0.5);
-            coord = rotate(rotation) * coord;
+            coord = rotate(radians(rotation)) * coord;
             coord += vec2(0.5);
             
-            vec4 texturePixels = texture2DRect(tex1, coord);
+            vec4 texturePixels = TEXTURE_UV(tex1, coord, u_texSize);
             
             color += texturePixels.rgb;
             
@@ -65,8 +66,7 @@ public:
         });
         rotation = 0;
         x = y = z = 0;
-        shader.setupShaderFromSource(GL_FRAGMENT_SHADER, shaderSource);
-        shader.linkProgram();
+        shader.setupFromSource(shaderSource);
         
         addInputConnection(DKConnectionType::DK_CHAIN);
         addChainOutputConnection(DKConnectionType::DK_CHAIN);
@@ -80,17 +80,19 @@ public:
     }
     void render(ofFbo& readFbo, ofFbo& writeFbo)
     {
+        ofShader& program = shader.get(readFbo);
         writeFbo.begin();
-        shader.begin();
-        shader.setUniform2f("u_resolution", getModuleWidth(), getModuleHeight());
-        shader.setUniform1f("x", x);
-        shader.setUniform1f("y", y);
-        shader.setUniform1f("z", z);
-        shader.setUniform1f("rotation", rotation);
+        program.begin();
+        program.setUniform2f("u_resolution", writeFbo.getWidth(), writeFbo.getHeight());
+        program.setUniform2f("u_texSize", DKTexture::getCoordScale(readFbo.getTexture()));
+        program.setUniform1f("x", x);
+        program.setUniform1f("y", y);
+        program.setUniform1f("z", z);
+        program.setUniform1f("rotation", rotation);
         
-        shader.setUniformTexture("tex1", readFbo.getTextureReference(), 1);
+        program.setUniformTexture("tex1", readFbo.getTextureReference(), 1);
         readFbo.draw(0, 0);
-        shader.end();
+        program.end();
         writeFbo.end();
     }
 };
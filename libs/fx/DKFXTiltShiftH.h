@@ -25,7 +25,7 @@ class DKFXTiltShiftH : public DKModule
 {
 private:
     bool gotChain;
-    ofShader shader;
+    DKShaderVariants shader;
     float h;
     float r;
 public:
@@ -35,32 +35,33 @@ public:
         r = 0.5;
         
         string fragShaderSrc = STRINGIFY(
-                                         uniform sampler2DRect tDiffuse;
+                                         uniform SAMPLER_TYPE tDiffuse;
+                                         uniform vec2 texSize;
+                                         uniform vec2 toPixels;
                                          uniform float h;
                                          uniform float r;
                                          
                                          void main() {
-                                             vec2 vUv = gl_TexCoord[0].st;
+                                             vec2 vUv = gl_TexCoord[0].st * toPixels;
                                              vec4 sum = vec4( 0.0 );
                                              
                                              float hh = h * abs( r - vUv.y );
                                              
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x - 4.0 * hh, vUv.y ) ) * 0.051;
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x - 3.0 * hh, vUv.y ) ) * 0.0918;
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x - 2.0 * hh, vUv.y ) ) * 0.12245;
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x - 1.0 * hh, vUv.y ) ) * 0.1531;
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x, vUv.y ) ) * 0.1633;
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x + 1.0 * hh, vUv.y ) ) * 0.1531;
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x + 2.0 * hh, vUv.y ) ) * 0.12245;
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x + 3.0 * hh, vUv.y ) ) * 0.0918;
-                                             sum += texture2DRect( tDiffuse, vec2( vUv.x + 4.0 * hh, vUv.y ) ) * 0.051;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x - 4.0 * hh, vUv.y ), texSize ) * 0.051;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x - 3.0 * hh, vUv.y ), texSize ) * 0.0918;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x - 2.0 * hh, vUv.y ), texSize ) * 0.12245;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x - 1.0 * hh, vUv.y ), texSize ) * 0.1531;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x, vUv.y ), texSize ) * 0.1633;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x + 1.0 * hh, vUv.y ), texSize ) * 0.1531;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x + 2.0 * hh, vUv.y ), texSize ) * 0.12245;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x + 3.0 * hh, vUv.y ), texSize ) * 0.0918;
+                                             sum += TEXTURE_PX( tDiffuse, vec2( vUv.x + 4.0 * hh, vUv.y ), texSize ) * 0.051;
                                              
                                              gl_FragColor = sum;
                                          }
                                          );
         
-        shader.setupShaderFromSource(GL_FRAGMENT_SHADER, fragShaderSrc);
-        shader.linkProgram();
+        shader.setupFromSource(fragShaderSrc);
         
         addInputConnection(DKConnectionType::DK_CHAIN);
         addChainOutputConnection(DKConnectionType::DK_CHAIN);
@@ -72,16 +73,19 @@ public:
     }
     void render(ofFbo& readFbo, ofFbo& writeFbo)
     {
+        glm::vec2 texSize(readFbo.getWidth(), readFbo.getHeight());
+        ofShader& program = shader.get(readFbo);
         writeFbo.begin();
         ofClear(0,0,0,0);
-        shader.begin();
-        shader.setUniformTexture("tDiffuse", readFbo.getTexture(), 1);
-        shader.setUniform2f("resolution", 1.f, 1.f);
-        shader.setUniform1f("h", h);
-        shader.setUniform1f("r", r);
+        program.begin();
+        program.setUniformTexture("tDiffuse", readFbo.getTexture(), 1);
+        program.setUniform2f("texSize", texSize);
+        program.setUniform2f("toPixels", texSize / DKTexture::getCoordScale(readFbo.getTexture()));
+        program.setUniform1f("h", h);
+        program.setUniform1f("r", r);
         //texturedQuad(0,0, 1920, 1080);
         readFbo.draw(0,0);
-        shader.end();
+        program.end();
         writeFbo.end();
     }
     void texturedQuad(float x, float y, float width, float height, float s = 1, float t = 1)
@@ -20,82 +20,328 @@
  SOFTWARE.
  */
 
-
 #include "constellation.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DK_PARTICLE_LANES 8
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DK_PARTICLE_LANES 4
+#endif
+
+// generic attribute that aliases no fixed function array
+#define DK_INSTANCE_POSITION 6
+
+// lit like ofDrawSphere/ofDrawBox under fixed function light 0, the
+// color material drives ambient and diffuse
+static string instanceVertShader = "#version 120\n" STRINGIFY(
+    attribute vec3 instancePosition;
+    uniform float size;
+    uniform int lighting;
+    void main()
+    {
+        vec4 position = vec4(gl_Vertex.xyz * size + instancePosition, 1.0);
+        gl_Position = gl_ModelViewProjectionMatrix * position;
+        gl_FrontColor = gl_Color;
+        
+        if (lighting == 1)
+        {
+            vec3 eyePosition = vec3(gl_ModelViewMatrix * position);
+            vec3 normal = normalize(gl_NormalMatrix * gl_Normal);
+            vec4 light = gl_LightSource[0].position;
+            vec3 toLight = normalize(light.w == 0.0 ? light.xyz : light.xyz - eyePosition);
+            float diffuse = max(dot(normal, toLight), 0.0);
+            vec3 ambient = gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb;
+            gl_FrontColor = vec4(gl_Color.rgb * (ambient + gl_LightSource[0].diffuse.rgb * diffuse), gl_Color.a);
+        }
+    }
+);
+
+static string instanceFragShader = "#version 120\n" STRINGIFY(
+    void main()
+    {
+        gl_FragColor = gl_Color;
+    }
+);
+
+// move one axis and flip the velocity of the particles that left [lo, hi]
+static inline void integrateAxis(float & p, float & v, float mult, float lo, float hi)
+{
+    p += v * mult;
+    if (p > hi || p < lo) v = -v;
+}
+
+#if defined(__AVX2__)
+static inline void integrateAxis(float * p, float * v, __m256 mult, __m256 lo, __m256 hi)
+{
+    __m256 vel = _mm256_loadu_ps(v);
+    __m256 pos = _mm256_add_ps(_mm256_loadu_ps(p), _mm256_mul_ps(vel, mult));
+    __m256 out = _mm256_or_ps(_mm256_cmp_ps(pos, hi, _CMP_GT_OQ), _mm256_cmp_ps(pos, lo, _CMP_LT_OQ));
+    _mm256_storeu_ps(p, pos);
+    _mm256_storeu_ps(v, _mm256_xor_ps(vel, _mm256_and_ps(out, _mm256_set1_ps(-0.0f))));
+}
+#elif defined(__ARM_NEON)
+static inline void integrateAxis(float * p, float * v, float32x4_t mult, float32x4_t lo, float32x4_t hi)
+{
+    float32x4_t vel = vld1q_f32(v);
+    float32x4_t pos = vmlaq_f32(vld1q_f32(p), vel, mult);
+    uint32x4_t out = vorrq_u32(vcgtq_f32(pos, hi), vcltq_f32(pos, lo));
+    vst1q_f32(p, pos);
+    vst1q_f32(v, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vel), vandq_u32(out, vdupq_n_u32(0x80000000)))));
+}
+#endif
+
 void Constellation::setup()
 {
 
     drawingMode = 0;
     connectionDistance = 100;
-    numParticles = 2000;
+    maxConnections = 20;
+    updateTime = 0;
     particleSize = 8.0;
     lineWidth = 1.0;
     velocityMultx = velocityMulty = velocityMultz = 1;
     
+    int size = (particleCapacity + 7) & ~7;
+    posX.resize(size);
+    posY.resize(size);
+    posZ.resize(size);
+    velX.resize(size);
+    velY.resize(size);
+    velZ.resize(size);
+    
+    for (int i=0; i<size; i++)
+    {
+        posX[i] = ofRandom(getModuleWidth());
+        posY[i] = ofRandom(getModuleHeight());
+        posZ[i] = ofRandom(-512, 512);
+        velX[i] = ofRandom(-1, 1);
+        velY[i] = ofRandom(-1, 1);
+        velZ[i] = ofRandom(-1, 1);
+    }
     
-    mesh.setMode(OF_PRIMITIVE_LINES);
-    mesh.clear();
-    meshPoints.setMode(OF_PRIMITIVE_POINTS);
-    meshPoints.clear();
-    meshPoints.enableIndices();
+    positionStream.allocate(size * 3 * sizeof(float));
+    numIndices = 0;
+    lines.setup();
     
-    for (int i=0; i<numParticles; i++)
+    // the instances read their position straight from the particle buffer
+    instancing = ofGLCheckExtension("GL_ARB_instanced_arrays") && ofGLCheckExtension("GL_ARB_draw_instanced");
+    if(instancing)
     {
-        ofVec3f pos(ofRandom(getModuleWidth()), ofRandom(getModuleHeight()), ofRandom(-512, 512));
-        mesh.addVertex(pos);
-        meshPoints.addVertex(pos);
-        ofVec3f randomVelocity = ofVec3f(ofRandom(-1, 1), ofRandom(-1, 1), ofRandom(-1, 1));
-        vel.push_back(randomVelocity);
+        instanceShader.setupShaderFromSource(GL_VERTEX_SHADER, instanceVertShader);
+        instanceShader.setupShaderFromSource(GL_FRAGMENT_SHADER, instanceFragShader);
+        instanceShader.bindAttribute(DK_INSTANCE_POSITION, "instancePosition");
+        instanceShader.linkProgram();
+        
+        sphereVbo.setMesh(ofSpherePrimitive(1, 20).getMesh(), GL_STATIC_DRAW);
+        boxVbo.setMesh(ofBoxPrimitive(1, 1, 1, 1, 1, 1).getMesh(), GL_STATIC_DRAW);
     }
     
-    numParticles = 1000;
     ofClear(0,0,0,0);
 }
 
 
 void Constellation::update()
 {
+    uint64_t start = ofGetElapsedTimeMicros();
     
     if(numParticles > 0)
     {
-        mesh.clearIndices();
-        meshPoints.clearIndices();
-        for (int i=0; i<numParticles; i++) {
-            ofVec3f point = mesh.getVertex(i);
-            point.x += vel[i].x * velocityMultx;
-            point.y += vel[i].y * velocityMulty;
-            point.z += vel[i].z * velocityMultz;
-
-            if(point.x > getModuleWidth() || point.x < 0)
-                vel[i].x = vel[i].x*-1;
-            if(point.y > getModuleHeight() || point.y < 0)
-                vel[i].y = vel[i].y*-1;
-            if(point.z > 700 || point.z < -1024)
-                vel[i].z = vel[i].z*-1;
-
-            mesh.setVertex(i, point);
-            meshPoints.setVertex(i, point);
-            meshPoints.addIndex(i);
-            
-            if(connectionDistance > 0)
+        // every chunk writes its positions straight into this frame's region
+        float * out = positionStream.map<float>();
+        int count = (numParticles + 7) & ~7;
+        DKThreadPool::get().parallelFor(count, 1024, [&](int begin, int end) { integrate(begin, end, out); });
+        positionStream.unmap();
+        
+        numIndices = 0;
+        if(connectionDistance > 0)
+        {
+            // every particle takes part in at most maxConnections lines
+            links.resize(numParticles * maxConnections);
+            numIndices = connectParticles(links.data());
+        }
+        
+        if(lineWidth > 0 && drawingMode != 4 && drawingMode != 5) writeSegments();
+        if(drawingMode >= 4 && numIndices > 0)
+        {
+            indexStream.reserve(numIndices * sizeof(ofIndexType));
+            ofIndexType * out = indexStream.map<ofIndexType>();
+            copy(links.begin(), links.begin() + numIndices, out);
+            indexStream.unmap();
+        }
+        attachStreams();
+    }
+    
+    updateTime = ofLerp(updateTime, (ofGetElapsedTimeMicros() - start) / 1000.0, 0.1);
+    if(ofGetFrameNum() % 30 == 0)
+    {
+        statsLabel->setLabel(ofToString(numParticles) + " particles " + ofToString(updateTime, 2) + " ms");
+    }
+}
+
+// runs on the thread pool, begin and end are multiples of 8
+void Constellation::integrate(int begin, int end, float * out)
+{
+    float w = getModuleWidth();
+    float h = getModuleHeight();
+    int i = begin;
+    
+#if defined(__AVX2__)
+    __m256 multX = _mm256_set1_ps(velocityMultx), multY = _mm256_set1_ps(velocityMulty), multZ = _mm256_set1_ps(velocityMultz);
+    __m256 zero = _mm256_setzero_ps(), width = _mm256_set1_ps(w), height = _mm256_set1_ps(h);
+    __m256 zMin = _mm256_set1_ps(-1024), zMax = _mm256_set1_ps(700);
+    for (; i + DK_PARTICLE_LANES <= end; i += DK_PARTICLE_LANES)
+    {
+        integrateAxis(&posX[i], &velX[i], multX, zero, width);
+        integrateAxis(&posY[i], &velY[i], multY, zero, height);
+        integrateAxis(&posZ[i], &velZ[i], multZ, zMin, zMax);
+    }
+#elif defined(__ARM_NEON)
+    float32x4_t multX = vdupq_n_f32(velocityMultx), multY = vdupq_n_f32(velocityMulty), multZ = vdupq_n_f32(velocityMultz);
+    float32x4_t zero = vdupq_n_f32(0), width = vdupq_n_f32(w), height = vdupq_n_f32(h);
+    float32x4_t zMin = vdupq_n_f32(-1024), zMax = vdupq_n_f32(700);
+    for (; i + DK_PARTICLE_LANES <= end; i += DK_PARTICLE_LANES)
+    {
+        integrateAxis(&posX[i], &velX[i], multX, zero, width);
+        integrateAxis(&posY[i], &velY[i], multY, zero, height);
+        integrateAxis(&posZ[i], &velZ[i], multZ, zMin, zMax);
+    }
+#endif
+    for (; i < end; i++)
+    {
+        integrateAxis(posX[i], velX[i], velocityMultx, 0, w);
+        integrateAxis(posY[i], velY[i], velocityMulty, 0, h);
+        integrateAxis(posZ[i], velZ[i], velocityMultz, -1024, 700);
+    }
+    
+    // interleaved copy for the gpu, the only write of this frame's positions
+    for (i = begin; i < end; i++)
+    {
+        out[i * 3] = posX[i];
+        out[i * 3 + 1] = posY[i];
+        out[i * 3 + 2] = posZ[i];
+    }
+}
+
+// point the vbos at the regions written this frame
+void Constellation::attachStreams()
+{
+    particles.setVertexBuffer(positionStream.getBuffer(), 3, 3 * sizeof(float), positionStream.getOffset());
+    if(indexStream.isAllocated()) particles.setIndexBuffer(indexStream.getBuffer());
+    
+    if(instancing)
+    {
+        for(ofVbo * vbo : { &sphereVbo, &boxVbo })
+        {
+            vbo->setAttributeBuffer(DK_INSTANCE_POSITION, positionStream.getBuffer(), 3, 3 * sizeof(float), positionStream.getOffset());
+            vbo->setAttributeDivisor(DK_INSTANCE_POSITION, 1);
+        }
+    }
+}
+
+// pairs of links are segments, the line strip mode joins consecutive ones
+void Constellation::writeSegments()
+{
+    bool strip = drawingMode == 3;
+    int count = strip ? max(numIndices - 1, 0) : numIndices / 2;
+    DKLineSegment * out = lines.map(count);
+    DKThreadPool::get().parallelFor(count, 4096, [&](int begin, int end)
+    {
+        for (int s = begin; s < end; s++)
+        {
+            int a = links[strip ? s : s * 2];
+            int b = links[strip ? s + 1 : s * 2 + 1];
+            out[s] = { { posX[a], posY[a], posZ[a] }, { posX[b], posY[b], posZ[b] }, ofFloatColor::white };
+        }
+    });
+    lines.unmap(count);
+}
+
+int Constellation::connectParticles(ofIndexType * out)
+{
+    // grid cells are as big as the connection distance, so every neighbour
+    // of a particle is in one of the 27 cells around it
+    float invCell = 1.0 / connectionDistance;
+    float maxDistance = connectionDistance * connectionDistance;
+    int gridX = getModuleWidth() * invCell + 1;
+    int gridY = getModuleHeight() * invCell + 1;
+    int gridZ = 1724 * invCell + 1;
+    int numCells = gridX * gridY * gridZ;
+    
+    // counting sort of the particles by cell, particles bouncing slightly
+    // out of bounds are clamped into the border cells
+    cellStart.assign(numCells + 1, 0);
+    particleCell.resize(numParticles);
+    for (int i = 0; i < numParticles; i++)
+    {
+        int cx = ofClamp(posX[i] * invCell, 0, gridX - 1);
+        int cy = ofClamp(posY[i] * invCell, 0, gridY - 1);
+        int cz = ofClamp((posZ[i] + 1024) * invCell, 0, gridZ - 1);
+        int c = (cz * gridY + cy) * gridX + cx;
+        particleCell[i] = c;
+        cellStart[c + 1]++;
+    }
+    for (int c = 0; c < numCells; c++) cellStart[c + 1] += cellStart[c];
+    
+    cellParticles.resize(numParticles);
+    vector<int> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < numParticles; i++) cellParticles[cursor[particleCell[i]]++] = i;
+    
+    connections.assign(numParticles, 0);
+    int n = 0;
+    
+    for (int i = 0; i < numParticles; i++)
+    {
+        if (connections[i] >= maxConnections) continue;
+        
+        int c = particleCell[i];
+        int cx = c % gridX;
+        int cy = (c / gridX) % gridY;
+        int cz = c / (gridX * gridY);
+        
+        for (int z = max(cz - 1, 0); z <= min(cz + 1, gridZ - 1); z++)
+        for (int y = max(cy - 1, 0); y <= min(cy + 1, gridY - 1); y++)
+        for (int x = max(cx - 1, 0); x <= min(cx + 1, gridX - 1); x++)
+        {
+            int cell = (z * gridY + y) * gridX + x;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1] && connections[i] < maxConnections; k++)
             {
-                ofVec3f verta = mesh.getVertex(i);
-                for (int b=i+1; b<numParticles-1; b++) {
-                    ofVec3f vertb = mesh.getVertex(b);
-                    float distance = verta.distance(vertb);
-                    if (distance <=  connectionDistance) {
-                        mesh.addIndex(i);
-                        mesh.addIndex(b);
-                    }
-                    
-                }
+                int b = cellParticles[k];
+                if (b <= i || connections[b] >= maxConnections) continue;
                 
+                float dx = posX[b] - posX[i];
+                float dy = posY[b] - posY[i];
+                float dz = posZ[b] - posZ[i];
+                if (dx * dx + dy * dy + dz * dz <= maxDistance)
+                {
+                    out[n++] = i;
+                    out[n++] = b;
+                    connections[i]++;
+                    connections[b]++;
+                }
             }
-            
         }
-        
     }
+    return n;
+}
+
+void Constellation::drawConnections(ofPrimitiveMode mode)
+{
+    if(lineWidth > 0 && numIndices > 0)
+    {
+        if(mode == OF_PRIMITIVE_LINES || mode == OF_PRIMITIVE_LINE_STRIP) lines.draw(lineWidth);
+        else particles.drawElements(ofGetGLPrimitiveMode(mode), numIndices, indexStream.getOffset() / sizeof(ofIndexType));
+    }
+}
+
+void Constellation::drawInstances(ofVbo & vbo)
+{
+    instanceShader.begin();
+    instanceShader.setUniform1f("size", particleSize);
+    instanceShader.setUniform1i("lighting", ofGetLightingEnabled() ? 1 : 0);
+    vbo.drawElementsInstanced(GL_TRIANGLES, vbo.getNumIndices(), numParticles);
+    instanceShader.end();
 }
 
 void Constellation::draw()
@@ -108,108 +354,67 @@ void Constellation::draw()
     
     ofSetColor(255);
     
-    if(particleSize > 0)
+    if(particleSize > 0 && numParticles > 0)
     {
         if (drawingMode == 0) {
-            mesh.setMode(OF_PRIMITIVE_LINES);
-            if(lineWidth > 0)
-            {
-                glEnable(GL_LINE_SMOOTH);
-                glLineWidth(lineWidth);
-                mesh.draw();
-            }
-            meshPoints.setMode(OF_PRIMITIVE_POINTS);
+            drawConnections(OF_PRIMITIVE_LINES);
             glEnable(GL_POINT_SMOOTH);
             glPointSize(particleSize);
-            meshPoints.draw();
+            particles.draw(GL_POINTS, 0, numParticles);
         } else if(drawingMode == 1)
         {
-            mesh.setMode(OF_PRIMITIVE_LINES);
-            if(lineWidth > 0)
+            drawConnections(OF_PRIMITIVE_LINES);
+            if(instancing)
             {
-                glEnable(GL_LINE_SMOOTH);
-                glLineWidth(lineWidth);
-                mesh.draw();
+                drawInstances(sphereVbo);
             }
-            for(int c = 0; c < numParticles; c++)
+            else for(int c = 0; c < numParticles; c++)
             {
-                ofVec3f p = meshPoints.getVertex(c);
-                ofDrawSphere(p.x, p.y, p.z, particleSize);
+                ofDrawSphere(posX[c], posY[c], posZ[c], particleSize);
             }
         }else if(drawingMode == 2)
         {            
-            mesh.setMode(OF_PRIMITIVE_LINES);
-            if(lineWidth > 0)
+            drawConnections(OF_PRIMITIVE_LINES);
+            if(instancing)
             {
-                glEnable(GL_LINE_SMOOTH);
-                glLineWidth(lineWidth);
-                mesh.draw();
+                drawInstances(boxVbo);
             }
-            for(int c = 0; c < numParticles; c++)
+            else for(int c = 0; c < numParticles; c++)
             {
-                ofVec3f p = meshPoints.getVertex(c);
-                ofDrawBox(p.x, p.y, p.z, particleSize, particleSize, particleSize);
+                ofDrawBox(posX[c], posY[c], posZ[c], particleSize, particleSize, particleSize);
             }
         }else if(drawingMode == 3)
         {
-            mesh.setMode(OF_PRIMITIVE_LINE_STRIP);
-            if(lineWidth > 0)
-            {
-                glEnable(GL_LINE_SMOOTH);
-                glLineWidth(lineWidth);
-                mesh.draw();
-            }
+            drawConnections(OF_PRIMITIVE_LINE_STRIP);
         }else if(drawingMode == 4)
         {
-            mesh.setMode(OF_PRIMITIVE_TRIANGLES);
-            if(lineWidth > 0)
-            {
-                glEnable(GL_LINE_SMOOTH);
-                glLineWidth(lineWidth);
-                mesh.draw();
-            }
+            drawConnections(OF_PRIMITIVE_TRIANGLES);
         }
         else if(drawingMode == 5)
         {
-            mesh.setMode(OF_PRIMITIVE_TRIANGLE_STRIP_ADJACENCY);
             ofPushStyle();
             ofNoFill();
-            if(lineWidth > 0)
-            {
-                glEnable(GL_LINE_SMOOTH);
-                glLineWidth(lineWidth);
-                mesh.draw();
-            }
+            drawConnections(OF_PRIMITIVE_TRIANGLE_STRIP_ADJACENCY);
             ofPopStyle();
         }
         
         else if(drawingMode == 6)
         {
-            mesh.setMode(OF_PRIMITIVE_LINES);
             ofPushStyle();
             ofNoFill();
-            if(lineWidth > 0)
-            {
-                glEnable(GL_LINE_SMOOTH);
-                glLineWidth(lineWidth);
-                mesh.draw();
-            }
-            meshPoints.clearVertices();
-            meshPoints.clearIndices();
-            meshPoints.setMode(OF_PRIMITIVE_TRIANGLES);
-            for(int i = 0; i<mesh.getNumIndices(); i++)
-            {
-                int ind = mesh.getIndex(i);
-                ofVec3f p = mesh.getVertex(ind);
-                meshPoints.addVertex(p);
-            }
-            meshPoints.draw();
+            drawConnections(OF_PRIMITIVE_LINES);
+            // the connections read as triangles, from the same index buffer
+            if(numIndices > 0) particles.drawElements(GL_TRIANGLES, numIndices, indexStream.getOffset() / sizeof(ofIndexType));
             
             ofPopStyle();
         }
     }
     
     //ofDisableDepthTest();
+    
+    // the regions drawn above can be rewritten once the gpu passed this point
+    positionStream.fence();
+    indexStream.fence();
 
     ofPopMatrix();
     //cam.end();
@@ -223,13 +428,15 @@ void Constellation::addModuleParameters()
     matrix->setRadioMode(true);
     matrix->setSelected({0});
     
-    addSlider("count", numParticles, 0, 2000, 500);
+    addSlider("count", numParticles, 0, particleCapacity, 500);
     addSlider("size", particleSize, 0, 50, 5);
     addSlider("vel x", velocityMultx, 0, 50, 1);
     addSlider("vel y", velocityMulty, 0, 50, 1);
     addSlider("vel z", velocityMultz, 0, 50, 1);
     addSlider("distance", connectionDistance, 50, 500, 100);
+    addSlider("max links", maxConnections, 1, 100, 20);
     addSlider("line width", lineWidth, 0, 10, 1);
+    statsLabel = gui->addLabel("");
 }
 
 void Constellation::onDrawingModeChange(ofxDatGuiMatrixEvent e)
@@ -35,9 +35,18 @@ public:
     
 private:
     
+    void integrate(int, int, float *);
+    int connectParticles(ofIndexType *);
+    void writeSegments();
+    void attachStreams();
+    void drawConnections(ofPrimitiveMode);
+    void drawInstances(ofVbo &);
+    
     // parameters
     float connectionDistance;
+    int maxConnections;
     int numParticles;
+    int particleCapacity = 50000;
     float particleSize;
     float time0;
     int drawingMode;
@@ -61,8 +70,33 @@ private:
 //    int ambientG;
 //    int ambientB;
     
-    ofMesh mesh;
-    ofMesh meshPoints;
-    vector<ofVec3f> vel;
+    // particle state as structure of arrays, padded to the simd width
+    vector<float> posX, posY, posZ;
+    vector<float> velX, velY, velZ;
+    
+    // positions written once per frame straight into gl memory, shared by
+    // the point and instanced draws; the connections become line segments,
+    // or indices for the modes that fill them
+    DKStreamBuffer positionStream;
+    DKStreamBuffer indexStream;
+    DKLineRenderer lines;
+    vector<ofIndexType> links;
+    ofVbo particles;
+    int numIndices;
+    
+    // unit sphere and box drawn once per particle in a single instanced call
+    ofVbo sphereVbo;
+    ofVbo boxVbo;
+    ofShader instanceShader;
+    bool instancing;
+    
+    // uniform grid, particles of cell c are cellParticles[cellStart[c] .. cellStart[c + 1]]
+    vector<int> cellStart;
+    vector<int> cellParticles;
+    vector<int> particleCell;
+    vector<int> connections;
+    
+    float updateTime;
+    ofxDatGuiLabel * statsLabel;
 
 };
@@ -22,6 +22,86 @@
 
 #include "terrain.hpp"
 
+// z of a grid vertex: the luminance of the heightmap when connected, 2d
+// simplex noise (the ofNoise family, ashima/gustavson) otherwise. Shared by
+// the surface and the line renderer so both displace the grid the same way.
+static string terrainHeightShader = STRINGIFY(
+    uniform SAMPLER_TYPE heightmap;
+    uniform vec2 heightmapSize;
+    uniform float useHeightmap;
+    uniform vec2 gridSize;
+    uniform float scale;
+    uniform float noiseScale;
+    uniform float flying;
+    
+    vec3 permute(vec3 x)
+    {
+        return mod(((x * 34.0) + 1.0) * x, 289.0);
+    }
+    
+    float snoise(vec2 v)
+    {
+        const vec4 C = vec4(0.211324865405187, 0.366025403784439, -0.577350269189626, 0.024390243902439);
+        vec2 i = floor(v + dot(v, C.yy));
+        vec2 x0 = v - i + dot(i, C.xx);
+        vec2 i1 = (x0.x > x0.y) ? vec2(1.0, 0.0) : vec2(0.0, 1.0);
+        vec4 x12 = x0.xyxy + C.xxzz;
+        x12.xy -= i1;
+        i = mod(i, 289.0);
+        vec3 p = permute(permute(i.y + vec3(0.0, i1.y, 1.0)) + i.x + vec3(0.0, i1.x, 1.0));
+        vec3 m = max(0.5 - vec3(dot(x0, x0), dot(x12.xy, x12.xy), dot(x12.zw, x12.zw)), 0.0);
+        m = m * m;
+        m = m * m;
+        vec3 x = 2.0 * fract(p * C.www) - 1.0;
+        vec3 h = abs(x) - 0.5;
+        vec3 a0 = x - floor(x + 0.5);
+        m *= 1.79284291400159 - 0.85373472095314 * (a0 * a0 + h * h);
+        vec3 g;
+        g.x = a0.x * x0.x + h.x * x0.y;
+        g.yz = a0.yz * x12.xz + h.yz * x12.yw;
+        return 130.0 * dot(m, g);
+    }
+    
+    vec3 terrainPosition(vec2 cell)
+    {
+        float z;
+        if (useHeightmap > 0.5)
+        {
+            vec2 uv = cell / max(gridSize - 1.0, vec2(1.0));
+            vec3 color = TEXTURE_UV(heightmap, uv, heightmapSize).rgb;
+            z = dot(color, vec3(0.2126, 0.7152, 0.0722)) * 200.0 - 100.0;
+        }
+        else
+        {
+            z = snoise(vec2(cell.x * noiseScale, flying + cell.y * noiseScale)) * 100.0;
+        }
+        return vec3(cell * scale, z);
+    }
+);
+
+static string terrainVertShader = STRINGIFY(
+    void main()
+    {
+        gl_Position = gl_ModelViewProjectionMatrix * vec4(terrainPosition(gl_Vertex.xy), 1.0);
+        gl_FrontColor = gl_Color;
+    }
+);
+
+// line segments hold (column, row) at both ends
+static string terrainLineShader = STRINGIFY(
+    vec3 linePosition(vec3 p)
+    {
+        return terrainPosition(p.xy);
+    }
+);
+
+static string terrainFragShader = STRINGIFY(
+    void main()
+    {
+        gl_FragColor = gl_Color;
+    }
+);
+
 void Terrain::setup()
 {
     drawingMode = GL_TRIANGLE_STRIP;
@@ -35,43 +115,116 @@ void Terrain::setup()
     lineWidth = 4.0;
     flying = noiseX = direction = rotate = translateX = translateY = translateZ = 0;
     
+    heightmap = nullptr;
+    gridCols = gridRows = gridMode = 0;
+    shader.setupFromSource(terrainHeightShader + terrainVertShader, terrainFragShader);
+    lines.setup(terrainHeightShader + terrainLineShader);
+    addInputConnection(DKConnectionType::DK_FBO);
+}
+
+void Terrain::buildGrid()
+{
+    gridCols = numCols;
+    gridRows = numRows;
     
-    for(int y = 0; y < numRows - 1; y++)
+    vector<float> cells;
+    cells.reserve(gridCols * gridRows * 2);
+    for(int y = 0; y < gridRows; y++)
     {
-        for(int x = 0; x < numCols; x++)
+        for(int x = 0; x < gridCols; x++)
         {
-            noise[x][y] = 0;
+            cells.push_back(x);
+            cells.push_back(y);
         }
     }
-    
+    vbo.setVertexData(cells.data(), 2, gridCols * gridRows, GL_STATIC_DRAW);
+    buildIndices();
 }
 
-void Terrain::update()
+void Terrain::buildIndices()
 {
-    flying -= ofMap(direction, -1, 1, -0.05, 0.05);
-    
-    float yoff = flying;
+    gridMode = drawingMode;
+    vector<ofIndexType> indices;
+    auto vertex = [this](int x, int y) { return (ofIndexType) (y * gridCols + x); };
     
-    float noiseNorm = ofMap(noiseX, 0, 1, 0, 0.1);
-    for(int y = 0; y < numRows - 1; y++)
+    if(drawingMode == GL_POINTS)
+    {
+        primitive = GL_POINTS;
+    }
+    else if(drawingMode == GL_LINES)
+    {
+        // the rungs between two rows
+        primitive = GL_LINES;
+        for(int y = 0; y < gridRows - 1; y++)
+        {
+            for(int x = 0; x < gridCols; x++)
+            {
+                indices.push_back(vertex(x, y));
+                indices.push_back(vertex(x, y + 1));
+            }
+        }
+    }
+    else if(drawingMode == GL_LINE_STRIP)
     {
-        float xoff = 0;
-        for(int x = 0; x < numCols; x++)
+        // the zigzag of each row strip, as separate segments so rows don't connect
+        primitive = GL_LINES;
+        for(int y = 0; y < gridRows - 1; y++)
         {
-            noise[x][y] = ofMap(ofNoise(xoff, yoff), 0, 1, -100, 100);
-            if(y == (int)numRows/2)
+            for(int x = 0; x < gridCols; x++)
             {
-                noise[x][y] = noise[x][y];
+                indices.push_back(vertex(x, y));
+                indices.push_back(vertex(x, y + 1));
+                if(x < gridCols - 1)
+                {
+                    indices.push_back(vertex(x, y + 1));
+                    indices.push_back(vertex(x + 1, y));
+                }
             }
-            xoff += noiseNorm;
         }
-        yoff += noiseNorm;
+    }
+    else
+    {
+        // quad and triangle strips cover the same surface, rows are joined
+        // by repeating the last and first vertex (degenerate triangles)
+        primitive = GL_TRIANGLE_STRIP;
+        for(int y = 0; y < gridRows - 1; y++)
+        {
+            if(y > 0) indices.push_back(vertex(0, y));
+            for(int x = 0; x < gridCols; x++)
+            {
+                indices.push_back(vertex(x, y));
+                indices.push_back(vertex(x, y + 1));
+            }
+            if(y < gridRows - 2) indices.push_back(vertex(gridCols - 1, y + 1));
+        }
+    }
+    
+    if(primitive == GL_LINES)
+    {
+        // the line modes go through the line renderer, (column, row) at both ends
+        vector<DKLineSegment> segments(indices.size() / 2);
+        for(size_t s = 0; s < segments.size(); s++)
+        {
+            ofIndexType a = indices[s * 2];
+            ofIndexType b = indices[s * 2 + 1];
+            segments[s].start = glm::vec3(a % gridCols, a / gridCols, 0);
+            segments[s].end = glm::vec3(b % gridCols, b / gridCols, 0);
+            segments[s].color = ofFloatColor::white;
+        }
+        lines.setSegments(segments);
+        indices.clear();
     }
     
-    //fbo.begin();
+    numIndices = indices.size();
+    if(numIndices > 0) vbo.setIndexData(indices.data(), numIndices, GL_STATIC_DRAW);
+}
+
+void Terrain::update()
+{
+    flying -= ofMap(direction, -1, 1, -0.05, 0.05);
     
-    //cam.end();
-    //fbo.end();
+    if(numCols != gridCols || numRows != gridRows) buildGrid();
+    else if(drawingMode != gridMode) buildIndices();
 }
 
 
@@ -86,23 +239,48 @@ void Terrain::draw()
     ofSetColor(255);
     ofNoFill();
 
-    glLineWidth(lineWidth);
     glPointSize(lineWidth);
-    for(int y = 0; y < numRows - 1; y++)
+    
+    if(primitive == GL_LINES)
     {
-        glBegin(drawingMode);
-        for(int x = 0; x < numCols; x++)
-        {
-            glVertex3f(x*scl, y*scl, noise[x][y]);
-            glVertex3f(x*scl, (y+1)*scl, noise[x][y+1]);
-        }
-        glEnd();
+        setUniforms(heightmap != nullptr ? lines.begin(lineWidth, *heightmap) : lines.begin(lineWidth));
+        lines.draw();
+        lines.end();
+    }
+    else
+    {
+        ofShader & program = heightmap != nullptr ? shader.get(*heightmap) : shader.get();
+        program.begin();
+        setUniforms(program);
+        if(primitive == GL_POINTS) vbo.draw(GL_POINTS, 0, gridCols * gridRows);
+        else if(numIndices > 0) vbo.drawElements(primitive, numIndices);
+        program.end();
     }
     
     ofPopStyle();
     ofPopMatrix();
     
 }
+
+void Terrain::setUniforms(ofShader & program)
+{
+    program.setUniform1f("useHeightmap", heightmap != nullptr);
+    if(heightmap != nullptr)
+    {
+        program.setUniformTexture("heightmap", heightmap->getTexture(), 0);
+        program.setUniform2f("heightmapSize", heightmap->getWidth(), heightmap->getHeight());
+    }
+    program.setUniform2f("gridSize", gridCols, gridRows);
+    program.setUniform1f("scale", scl);
+    program.setUniform1f("noiseScale", ofMap(noiseX, 0, 1, 0, 0.1));
+    program.setUniform1f("flying", flying);
+}
+
+void Terrain::setFbo(ofFbo * fboPtr)
+{
+    heightmap = fboPtr;
+}
+
 void Terrain::addModuleParameters()
 {
     
@@ -112,6 +290,8 @@ void Terrain::addModuleParameters()
     
     addSlider("rotate", rotate, 0, 180, 0);
     addSlider("scale", scl, 0, 100, 100);
+    addSlider("columns", numCols, 2, 1024, 60);
+    addSlider("rows", numRows, 2, 1024, 60);
     addSlider("translate x", translateX, -1545, -45, 0);
     addSlider("translate y", translateY, -1500, 0, 0);
     addSlider("translate z", translateZ, -1500, 1500, 0);
@@ -32,10 +32,15 @@ public:
     void update();
     void draw();
     void addModuleParameters();
+    void setFbo(ofFbo *);
     void onSliderEvent(ofxDatGuiSliderEvent e);
     void onDrawingModeChange(ofxDatGuiMatrixEvent);
     
 private:
+    void buildGrid();
+    void buildIndices();
+    void setUniforms(ofShader &);
+    
     int drawingMode;
     int numRows;
     int numCols;
@@ -50,8 +55,20 @@ private:
     float noiseX;
     float direction;
     float lineWidth;
-    ofMesh mesh;
-    float noise[60][60];
+    
+    // static grid of (column, row) vertices, the vertex shader displaces z
+    // from noise or from the heightmap input, so nothing is uploaded per frame
+    ofVbo vbo;
+    DKShaderVariants shader;
+    // the line modes, segments between grid cells displaced the same way
+    DKLineRenderer lines;
+    ofFbo * heightmap;
+    int gridCols;
+    int gridRows;
+    int gridMode;
+    // what drawingMode is drawn with, strips of all rows joined into one call
+    GLenum primitive;
+    int numIndices;
 };
 
 
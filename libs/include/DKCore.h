@@ -21,6 +21,20 @@
  */
 
 #include "DKModule.hpp"
+#include "DKTexture.hpp"
+#include "DKReadback.hpp"
+#include "DKGLState.hpp"
+#include "DKThreadPool.hpp"
+#include "DKStreamBuffer.hpp"
+#include "DKLineRenderer.hpp"
+#include "DKNoise.hpp"
+#include "DKLfoEngine.hpp"
+#include "DKThumbnailAtlas.hpp"
+#include "DKPresetBank.hpp"
+#include "DKMidiDispatch.hpp"
+#include "DKCueList.hpp"
+#include "DKFontCache.hpp"
+#include "DKGpuTimer.hpp"
 #include "DKMediaPool.hpp"
 #include "DKWireConnection.hpp"
 #include "DKWire.hpp"
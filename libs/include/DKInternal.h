@@ -20,13 +20,16 @@
  SOFTWARE.
  */
 
+#include "DKAnalyze.hpp"
 #include "DKChain.h"
 #include "DKConfig.hpp"
+#include "DKCrop.hpp"
 #include "DKLight.hpp"
 #include "DKLiveShader.hpp"
 #include "DKLfo.hpp"
 #include "DKPreview.hpp"
 #include "DKMixer.hpp"
+#include "DKNoiseBank.hpp"
 #include "DKPerlin.hpp"
 #include "DKScreenOutput.hpp"
 #include "DKSliderInverter.hpp"
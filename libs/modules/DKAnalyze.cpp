@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "DKAnalyze.hpp"
+
+// the input can be a mipmapped 2D fbo, the pyramid levels are rectangles
+static string analyzeFragShader = STRINGIFY
+(
+ uniform SAMPLER_TYPE src;
+ uniform SAMPLER_TYPE prev;
+ uniform vec2 scale;
+ uniform vec2 texSize;
+ uniform int mode;
+ 
+ void main()
+ {
+     vec2 origin = floor(gl_FragCoord.xy) * scale;
+     vec2 stp = scale * 0.25;
+     vec4 sum = vec4(0.0);
+     
+     for (int y = 0; y < 4; y++)
+     {
+         for (int x = 0; x < 4; x++)
+         {
+             vec2 coord = origin + (vec2(x, y) + 0.5) * stp;
+             vec4 texel = TEXTURE_PX(src, coord, texSize);
+             
+             if (mode == 0)
+             {
+                 texel.a = dot(texel.rgb, vec3(0.2126, 0.7152, 0.0722));
+             }
+             else if (mode == 2)
+             {
+                 texel.a = abs(texel.a - TEXTURE_PX(prev, coord, texSize).a);
+             }
+             sum += texel;
+         }
+     }
+     gl_FragColor = sum / 16.0;
+ }
+);
+
+void DKAnalyze::setup()
+{
+    ofFbo::Settings s;
+    s.internalformat = GL_RGBA32F;
+    s.textureTarget = GL_TEXTURE_RECTANGLE_ARB;
+    
+    s.width = s.height = 256;
+    level256.allocate(s);
+    
+    s.width = s.height = 64;
+    for (int i = 0; i < 2; i++)
+    {
+        level64[i].allocate(s);
+        level64[i].begin();
+        ofClear(0, 0, 0, 0);
+        level64[i].end();
+    }
+    
+    s.width = s.height = 16;
+    level16.allocate(s);
+    
+    s.width = s.height = DK_ANALYZE_GRID;
+    level4.allocate(s);
+    
+    readback.setup(&level4);
+    
+    shader.setupFromSource(analyzeFragShader);
+    
+    currentLevel64 = 0;
+    luma = red = green = blue = motion = 0.0;
+    motionGain = 4.0;
+    for (int i = 0; i < DK_ANALYZE_GRID * DK_ANALYZE_GRID; i++) grid[i] = 0.0;
+    
+    fboIn = nullptr;
+    gotTexture = false;
+    
+    addInputConnection(DKConnectionType::DK_FBO);
+}
+
+void DKAnalyze::update()
+{
+    if (!gotTexture) return;
+    
+    ofFbo& current = level64[currentLevel64];
+    ofFbo& previous = level64[1 - currentLevel64];
+    
+    ofPushStyle();
+    ofDisableAlphaBlending();
+    reduce(*fboIn, level256, 0, nullptr);
+    reduce(level256, current, 1, nullptr);
+    reduce(current, level16, 2, &previous);
+    reduce(level16, level4, 1, nullptr);
+    ofPopStyle();
+    
+    // queue this frame's 4x4 values, the ones we read are a couple of frames old
+    readback.update();
+    DKReadbackFrame frame;
+    if (readback.map(frame))
+    {
+        readResults((const float*) frame.data);
+        readback.unmap();
+    }
+    
+    currentLevel64 = 1 - currentLevel64;
+}
+
+void DKAnalyze::reduce(ofFbo& read, ofFbo& write, int mode, ofFbo* previous)
+{
+    // prev is only read in the 64 level diff, which has the same size and profile as src
+    ofShader& program = shader.get(read);
+    write.begin();
+    ofClear(0, 0, 0, 0);
+    program.begin();
+    program.setUniformTexture("src", read.getTexture(), 1);
+    program.setUniform2f("scale", read.getWidth() / write.getWidth(), read.getHeight() / write.getHeight());
+    program.setUniform2f("texSize", read.getWidth(), read.getHeight());
+    program.setUniform1i("mode", mode);
+    if (previous != nullptr)
+    {
+        program.setUniformTexture("prev", previous->getTexture(), 2);
+    }
+    ofDrawRectangle(0, 0, write.getWidth(), write.getHeight());
+    program.end();
+    write.end();
+}
+
+void DKAnalyze::readResults(const float* pixels)
+{
+    int numCells = DK_ANALYZE_GRID * DK_ANALYZE_GRID;
+    float r = 0, g = 0, b = 0, m = 0;
+    
+    for (int i = 0; i < numCells; i++)
+    {
+        const float* cell = pixels + i * 4;
+        grid[i] = cell[0] * 0.2126 + cell[1] * 0.7152 + cell[2] * 0.0722;
+        r += cell[0];
+        g += cell[1];
+        b += cell[2];
+        m += cell[3];
+    }
+
+    red = r / numCells;
+    green = g / numCells;
+    blue = b / numCells;
+    luma = red * 0.2126 + green * 0.7152 + blue * 0.0722;
+    motion = ofClamp(m / numCells * motionGain, 0.0, 1.0);
+}
+
+void DKAnalyze::addModuleParameters()
+{
+    addSlider("motion gain", motionGain, 1.0, 20.0, 4.0, 2);
+    gui->addSlider("luma", 0, 1, 0)->setPrecision(4)->bind(luma);
+    gui->addSlider("red", 0, 1, 0)->setPrecision(4)->bind(red);
+    gui->addSlider("green", 0, 1, 0)->setPrecision(4)->bind(green);
+    gui->addSlider("blue", 0, 1, 0)->setPrecision(4)->bind(blue);
+    gui->addSlider("motion", 0, 1, 0)->setPrecision(4)->bind(motion);
+    
+    ofxDatGuiFolder* gridFolder = gui->addFolder("GRID");
+    for (int i = 0; i < DK_ANALYZE_GRID * DK_ANALYZE_GRID; i++)
+    {
+        gridFolder->addSlider("cell " + ofToString(i), 0, 1, 0)->setPrecision(4)->bind(grid[i]);
+    }
+}
+
+void DKAnalyze::setFbo(ofFbo* fboptr)
+{
+    fboIn = fboptr;
+    gotTexture = fboptr != nullptr;
+    readback.setup(&level4);
+}
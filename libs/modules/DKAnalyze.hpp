@@ -0,0 +1,64 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef DKAnalyze_hpp
+#define DKAnalyze_hpp
+
+#include "DKModule.hpp"
+
+#define DK_ANALYZE_GRID 4
+
+class DKAnalyze : public DKModule
+{
+public:
+    void setup();
+    void update();
+    void addModuleParameters();
+    void setFbo(ofFbo*);
+private:
+    void reduce(ofFbo&, ofFbo&, int, ofFbo*);
+    void readResults(const float*);
+    
+    bool gotTexture;
+    ofFbo* fboIn;
+    DKShaderVariants shader;
+    
+    // reduction pyramid: input -> 256 -> 64 -> 16 -> 4
+    // the 64 level is double buffered so we can diff against the previous frame
+    ofFbo level256;
+    ofFbo level64[2];
+    ofFbo level16;
+    ofFbo level4;
+    unsigned currentLevel64;
+    
+    DKReadback readback;
+    
+    float luma;
+    float red;
+    float green;
+    float blue;
+    float motion;
+    float motionGain;
+    float grid[DK_ANALYZE_GRID * DK_ANALYZE_GRID];
+};
+
+#endif /* DKAnalyze_hpp */
@@ -24,17 +24,7 @@
 
 void DKChain::setup()
 {
-    ofFbo::Settings s;
-    s.width = getModuleWidth();
-    s.height = getModuleHeight();
-    s.textureTarget = GL_TEXTURE_RECTANGLE_ARB;
-
-    for (int i = 0; i < 2; i++)
-    {
-        pingPong[i].allocate(s);
-    }
-    
-    raw.allocate(s);
+    allocate();
     numFx = currentReadFbo = 0;
 
     addInputConnection(DKConnectionType::DK_FBO);
@@ -45,6 +35,40 @@ void DKChain::setup()
     fboIn = nullptr;
 }
 
+void DKChain::allocate()
+{
+    ofFbo::Settings s = DKTexture::getFboSettings(getModuleWidth(), getModuleHeight(), profile);
+
+    for (int i = 0; i < 2; i++)
+    {
+        DKTexture::release(pingPong[i]);
+        pingPong[i].allocate(s);
+    }
+    
+    DKTexture::release(raw);
+    raw.allocate(s);
+}
+
+void DKChain::unMount()
+{
+    for (int i = 0; i < 2; i++)
+    {
+        DKTexture::release(pingPong[i]);
+    }
+    DKTexture::release(raw);
+}
+
+void DKChain::addModuleParameters()
+{
+    gui->addToggle("mipmaps", false)->onToggleEvent(this, &DKChain::onMipmapsToggle);
+}
+
+void DKChain::onMipmapsToggle(ofxDatGuiToggleEvent e)
+{
+    profile = e.target->getChecked() ? DKTextureProfile::DK_MIPMAP_2D : DKTextureProfile::DK_RECTANGLE;
+    allocate();
+}
+
 void DKChain::update()
 {
     if(gotTexture)
@@ -63,6 +87,7 @@ void DKChain::draw()
         pingPong[currentReadFbo].draw(0,0);
     }
     raw.end();
+    DKTexture::touch(raw);
 }
 
 void DKChain::processChain(ofFbo& read, ofFbo& write, DKModule* cModule)
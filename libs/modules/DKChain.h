@@ -31,14 +31,19 @@ public:
     void setup();
     void update();
     void draw();
+    void addModuleParameters();
     ofFbo* getFbo();
     void setFbo(ofFbo*);
+    void onMipmapsToggle(ofxDatGuiToggleEvent);
+    void unMount();
 private:
+    void allocate();
 
     void processChain(ofFbo&, ofFbo&, DKModule*);
     unsigned currentReadFbo;
     unsigned numFx = 0;
     bool gotTexture;
+    DKTextureProfile profile = DKTextureProfile::DK_RECTANGLE;
     
     ofFbo raw;
     ofFbo* fboIn;
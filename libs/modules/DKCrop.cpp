@@ -0,0 +1,61 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "DKCrop.hpp"
+
+void DKCrop::setup()
+{
+    view.fbo = nullptr;
+    view.region.set(0, 0, getModuleWidth(), getModuleHeight());
+    heads = head = 1;
+    
+    addInputConnection(DKConnectionType::DK_FBO);
+    addOutputConnection(DKConnectionType::DK_TEXTURE);
+}
+
+void DKCrop::update()
+{
+    if(view.fbo == nullptr) return;
+    
+    int numHeads = ofClamp(heads, 1, 3);
+    int currentHead = ofClamp(head, 1, numHeads);
+    float headWidth = view.fbo->getWidth() / numHeads;
+    
+    view.region.set(headWidth * (currentHead - 1), 0, headWidth, view.fbo->getHeight());
+}
+
+void DKCrop::addModuleParameters()
+{
+    addSlider("heads", heads, 1, 3, 1);
+    addSlider("head", head, 1, 3, 1);
+}
+
+void DKCrop::setFbo(ofFbo* fboptr)
+{
+    view.fbo = fboptr;
+    update();
+}
+
+DKTextureView* DKCrop::getTextureView()
+{
+    return &view;
+}
@@ -26,60 +26,18 @@ void DKLfo::setup()
 {
     icons.load("icons/lfoWaves.png");
     icons.resize(153, 13);
-	
-    wave = 0;
-    time = 0;
-    amplitude = 1;  
-    offset = 0;
-    result = 0;
 }
 
 void DKLfo::update()
 {
+    DKLfoEngine & engine = DKLfoEngine::get();
     
-    switch(wave){
-        case 0: {
-            //sine wave
-            result = (1 - ((1+cos (PI* (time*2)))*0.5 ));
-            break;
-        }
-        case 1: {
-            //linear wave
-            int parity = ((int)floor(time*2))%2;
-            if(parity==0){
-                result = fmod(time, 1) * 2;
-            }else{
-                result = 2 - (fmod(time,1) * 2);
-            }
-            break;
-        }
-        case 2: {
-            //square wave
-            result = round (fmod (time,1));
-            break;
-        }
-        case 3: {
-            // in
-            result = fmod (time*2,1);
-            break;
-        }
-        case 4: {
-            // out
-            result = 1 - fmod (time*2,1);
-            break;
-        }
-        case 5: {
-            // random
-            if((int) fmod(ceil((time-0.5)*2),2) == 1)
-            {
-                result = ofRandom(0,1);
-            }
-        }
-    }
-    result *= amplitude;
-    result += offset;
+    // the tempo is shared, whichever lfo moves its slider sets it for all
+    if (bpm != lastBpm) engine.setTempo(bpm);
+    else bpm = engine.getTempo();
+    lastBpm = bpm;
     
-    //valuePlotter->setValue(result);
+    if (slot >= 0) engine.set(slot, wave, rate, sync, phase, amplitude, offset);
 }
 
 void DKLfo::draw()
@@ -88,25 +46,55 @@ void DKLfo::draw()
     icons.draw(gui->getPosition().x + size, gui->getPosition().y + 30);
 }
 
+void DKLfo::unMount()
+{
+    DKLfoEngine::get().remove(slot);
+    slot = -1;
+}
+
 void DKLfo::addModuleParameters()
 {
+    wave = DKLfoWave::DK_SINE;
+    sync = false;
+    rate = 1;
+    bpm = lastBpm = 120;
+    phase = 0;
+    amplitude = 1;
+    offset = 0;
+    
     ofxDatGuiMatrix * matrix = gui->addMatrix("wave", 6, false);
     matrix->onMatrixEvent(this, &DKLfo::onWaveSelected);
     matrix->setRadioMode(true);
     matrix->getChildAt(0)->setSelected(true);
     
-    gui->addSlider("time", 0, 1, 0)->setPrecision(4)->bind(time);
-    gui->addSlider("amplitude",0, 1,0)->setPrecision(3)->bind(amplitude);
-    gui->addSlider("offset", 0, 1, 0)->setPrecision(3)->bind(offset);
-    gui->addSlider("result", 0, 1, 0)->setPrecision(4)->bind(result);
+    gui->addToggle("sync", false)->onToggleEvent(this, &DKLfo::onSyncToggle);
+    addSlider("rate", rate, 0, 8, 1, 3);
+    addSlider("bpm", bpm, 20, 300, 120, 1);
+    addSlider("phase", phase, 0, 1, 0, 3);
+    addSlider("amplitude", amplitude, 0, 1, 1, 3);
+    addSlider("offset", offset, 0, 1, 0, 3);
     
-   // valuePlotter = gui->addValuePlotter("LFO", 0, 1);
-
-    //myWaveMonitor->setFrequencyLimit(float limit);
-    //myWaveMonitor->setDrawMode(ofxDatGuiGraph drawMode);
+    // a quarter cycle apart, written by the engine
+    outputs[0] = gui->addSlider("result", 0, 1, 0);
+    outputs[1] = gui->addSlider("result 90", 0, 1, 0);
+    outputs[2] = gui->addSlider("result 180", 0, 1, 0);
+    outputs[3] = gui->addSlider("result 270", 0, 1, 0);
+    for (auto output : outputs) output->setPrecision(4);
+    
+    // the engine evaluates every lfo and fills the output sliders before
+    // the wires read them, see ofxDarkKnight::update. Taken here and not in
+    // setup, which runs again on every resolution change
+    slot = DKLfoEngine::get().add();
+    for (int k = 0; k < DKLfoEngine::numOutputs; k++) DKLfoEngine::get().setOutput(slot, k, outputs[k]);
 }
 
 void DKLfo::onWaveSelected(ofxDatGuiMatrixEvent e)
 {
-    wave = e.child;
+    wave = (DKLfoWave) e.child;
+}
+
+void DKLfo::onSyncToggle(ofxDatGuiToggleEvent e)
+{
+    // synced rates are cycles per beat, free ones cycles per second
+    sync = e.target->getChecked();
 }
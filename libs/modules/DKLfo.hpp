@@ -29,18 +29,24 @@ class DKLfo : public DKModule
 {
 private:
     ofImage icons;
-    float time;
+    int slot = -1;
+    DKLfoWave wave;
+    float rate;
+    bool sync;
+    float bpm;
+    float lastBpm;
+    float phase;
     float offset;
     float amplitude;
-    float result;
-    unsigned int wave;
-    //ofxDatGuiValuePlotter* valuePlotter;
+    ofxDatGuiSlider * outputs[DKLfoEngine::numOutputs];
 public:
     void setup();
     void update();
     void draw();
     void addModuleParameters();
+    void unMount();
     void onWaveSelected(ofxDatGuiMatrixEvent);
+    void onSyncToggle(ofxDatGuiToggleEvent);
 };  
 
 #endif /* LfoSlider_hpp */
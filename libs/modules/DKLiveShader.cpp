@@ -85,6 +85,7 @@ void DKLiveShader::draw()
 
 		autoShader.end();
 		fbo.end();
+		DKTexture::touch(fbo);
 		ofDisableAlphaBlending();
 		ofPopStyle();
 		if (gotTexture)
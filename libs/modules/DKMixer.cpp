@@ -43,8 +43,7 @@ void DKMixer::setup()
     blendMode = 0;
     chainModule = nullptr;
     alphaMaster = alpha1 = alpha2 = 1.0;
-    shader.setupShaderFromSource(GL_FRAGMENT_SHADER, psBlendFragShaderGL2);
-    shader.linkProgram();
+    shader.setupFromSource(psBlendFragShaderGL2);
 
     fboInputs[0] = nullptr;
     fboInputs[1] = nullptr;
@@ -58,35 +57,42 @@ void DKMixer::update()
 
 void DKMixer::draw()
 {
+    // the variant follows the first connected input, both layers are
+    // expected to share its texture profile
+    ofFbo* profileInput = fboInputs[0] != nullptr ? fboInputs[0] : fboInputs[1];
+    ofShader& program = profileInput != nullptr ? shader.get(*profileInput) : shader.get();
+    
     raw.begin();
     ofClear(0,0,0,255);
-    shader.begin();
+    program.begin();
     
     int read1 = 0, read2 = 0;
     
     if(fboInputs[0] != nullptr)
     {
-        shader.setUniformTexture("base", fboInputs[0]->getTextureReference(), 1);
+        program.setUniformTexture("base", fboInputs[0]->getTextureReference(), 1);
+        program.setUniform2f("baseSize", fboInputs[0]->getWidth(), fboInputs[0]->getHeight());
         read1 = 1;
     }
     
     if(fboInputs[1] != nullptr)
     {
-        shader.setUniformTexture("blendTgt", fboInputs[1]->getTextureReference(), 2);
+        program.setUniformTexture("blendTgt", fboInputs[1]->getTextureReference(), 2);
+        program.setUniform2f("blendSize", fboInputs[1]->getWidth(), fboInputs[1]->getHeight());
         read2 = 1;
     }
     
     
-    shader.setUniform1f("alpha1", alpha1);
-    shader.setUniform1f("alpha2", alpha2);
-    shader.setUniform1f("master", alphaMaster);
-    shader.setUniform1i("mode", blendMode);
-    shader.setUniform1i("read1", read1);
-    shader.setUniform1i("read2", read2);
+    program.setUniform1f("alpha1", alpha1);
+    program.setUniform1f("alpha2", alpha2);
+    program.setUniform1f("master", alphaMaster);
+    program.setUniform1i("mode", blendMode);
+    program.setUniform1i("read1", read1);
+    program.setUniform1i("read2", read2);
     
     drawPlane();
     
-    shader.end();
+    program.end();
     raw.end();
     
     numFx = 0;
@@ -100,7 +106,7 @@ void DKMixer::draw()
         pingPong[currentReadFbo].draw(0,0);
         raw.end();
     }
-    
+    DKTexture::touch(raw);
 }
 
 void DKMixer::addModuleParameters()
@@ -25,9 +25,8 @@
 
 #include "DKModule.hpp"
 
-static string psBlendFragShaderGL2 = "#version 120\n \
-#extension GL_ARB_texture_rectangle : enable\n \
-\
+// version, sampler and lookup macros come from the DKShaderVariants header
+static string psBlendFragShaderGL2 = "\
 #define BlendLinearDodgef BlendAddf\n \
 #define BlendLinearBurnf BlendSubstractf\n \
 #define BlendAddf(base, blend) min(base + blend, 1.0)\n \
@@ -195,8 +194,10 @@ STRINGIFY
      return HSLToRGB(vec3(baseHSL.r, baseHSL.g, RGBToHSL(blend).b));
  }
  
- uniform sampler2DRect base;
- uniform sampler2DRect blendTgt;
+ uniform SAMPLER_TYPE base;
+ uniform SAMPLER_TYPE blendTgt;
+ uniform vec2 baseSize;
+ uniform vec2 blendSize;
  uniform int mode;
  uniform float alpha1;
  uniform float alpha2;
@@ -211,7 +212,7 @@ STRINGIFY
      
      if(read1 == 1)
      {
-         baseCol = texture2DRect(base, gl_TexCoord[0].st);
+         baseCol = TEXTURE_PX(base, gl_TexCoord[0].st, baseSize);
      } else
      {
          baseCol = vec4(0,0,0,0);
@@ -219,7 +220,7 @@ STRINGIFY
      
      if(read2 == 1)
      {
-         blendCol = texture2DRect(blendTgt, gl_TexCoord[0].st);
+         blendCol = TEXTURE_PX(blendTgt, gl_TexCoord[0].st, blendSize);
      } else
      {
          blendCol = vec4(0,0,0,0);
@@ -355,7 +356,7 @@ private:
     unsigned currentReadFbo;
     unsigned numFx = 0;
     bool gotTexture;
-    ofShader shader;
+    DKShaderVariants shader;
     ofxDatGuiLabel* guiLabel;
     
     ofFbo raw;
@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2019 Luis Fernando García Pérez [http://luiscript.com]
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "DKNoiseBank.hpp"
+
+void DKNoiseBank::setup()
+{
+    seeds.resize(maxChannels);
+    rates.resize(maxChannels, 1.0);
+    amplitudes.resize(maxChannels, 1.0);
+    offsets.resize(maxChannels, 0.0);
+    phases.resize(maxChannels, 0.0);
+    values.resize(maxChannels, 0.0);
+    
+    // seeds land on different lattice rows so channels stay decorrelated
+    for (int i = 0; i < maxChannels; i++) seeds[i] = ofRandom(0, 256);
+    
+    loadedChannel = -1;
+    shownChannels = 0;
+    resizeChannels();
+}
+
+void DKNoiseBank::update()
+{
+    editChannel = ofClamp(editChannel, 1, numChannels);
+    if (editChannel - 1 != loadedChannel)
+    {
+        loadChannel();
+    }
+    else
+    {
+        // amplitude + offset is the top of the signal, the channel sliders end at 1
+        offset = MIN(offset, 1.0f - amplitude);
+        seeds[loadedChannel] = seed;
+        rates[loadedChannel] = rate;
+        amplitudes[loadedChannel] = amplitude;
+        offsets[loadedChannel] = offset;
+    }
+    
+    if (numChannels != shownChannels) resizeChannels();
+    
+    // phases accumulate so a rate change never jumps the signal
+    float dt = ofGetLastFrameTime();
+    for (int i = 0; i < numChannels; i++) phases[i] += rates[i] * dt;
+    
+    DKNoise::batch(type, phases.data(), seeds.data(), values.data(), numChannels);
+    
+    for (int i = 0; i < numChannels; i++)
+    {
+        values[i] = (values[i] * 0.5 + 0.5) * amplitudes[i] + offsets[i];
+    }
+    
+    // pushed directly, bound sliders only refresh while their folder is open
+    for (int i = 0; i < numChannels; i++) channelSliders[i]->setValue(values[i], false);
+}
+
+void DKNoiseBank::draw()
+{
+    
+}
+
+void DKNoiseBank::resizeChannels()
+{
+    numChannels = ofClamp(numChannels, 1, maxChannels);
+    
+    // sliders are only ever added, extra ones are hidden when the bank shrinks
+    while ((int) channelSliders.size() < numChannels)
+    {
+        int index = channelSliders.size();
+        ofxDatGuiSlider * slider = channelsFolder->addSlider("ch " + ofToString(index + 1), 0, 1, 0);
+        slider->setPrecision(4);
+        if (getModuleMidiMapMode() != slider->getMidiMode()) slider->toggleMidiMode();
+        channelSliders.push_back(slider);
+    }
+    for (int i = 0; i < (int) channelSliders.size(); i++) channelSliders[i]->setVisible(i < numChannels);
+    shownChannels = numChannels;
+}
+
+void DKNoiseBank::loadChannel()
+{
+    loadedChannel = editChannel - 1;
+    seed = seeds[loadedChannel];
+    rate = rates[loadedChannel];
+    amplitude = amplitudes[loadedChannel];
+    offset = offsets[loadedChannel];
+}
+
+void DKNoiseBank::addModuleParameters()
+{
+    type = DKNoiseType::DK_SIMPLEX;
+    numChannels = 8;
+    editChannel = 1;
+    seed = 0;
+    rate = 1;
+    amplitude = 1;
+    offset = 0;
+    
+    ofxDatGuiMatrix * matrix = gui->addMatrix("type", 3, false);
+    matrix->onMatrixEvent(this, &DKNoiseBank::onTypeSelected);
+    matrix->setRadioMode(true);
+    matrix->getChildAt(0)->setSelected(true);
+    
+    addSlider("channels", numChannels, 1, maxChannels, 8);
+    addSlider("edit", editChannel, 1, maxChannels, 1);
+    addSlider("seed", seed, 0, 256, 0);
+    addSlider("rate", rate, 0, 4, 1);
+    addSlider("amplitude", amplitude, 0, 1, 1);
+    addSlider("offset", offset, 0, 1, 0);
+    
+    channelsFolder = gui->addFolder("CHANNELS");
+}
+
+void DKNoiseBank::onTypeSelected(ofxDatGuiMatrixEvent e)
+{
+    type = (DKNoiseType) e.child;
+}
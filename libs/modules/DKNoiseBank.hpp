@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2019 Luis Fernando García Pérez [http://luiscript.com]
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef DKNoiseBank_hpp
+#define DKNoiseBank_hpp
+
+#include "DKModule.hpp"
+
+// Many independent noise signals from one module: every channel has its own
+// seed, rate, amplitude and offset, and all of them are evaluated in a single
+// DKNoise batch per frame. Channel values are sliders inside a collapsible
+// folder so each one can be wired to a DK_SLIDER input; the per-channel
+// parameters are edited through one set of sliders pointed at "edit".
+class DKNoiseBank : public DKModule
+{
+private:
+    static const int maxChannels = 256;
+    
+    int numChannels;
+    int shownChannels;
+    int editChannel;
+    int loadedChannel;
+    DKNoiseType type;
+    
+    // one entry per channel
+    vector<float> seeds;
+    vector<float> rates;
+    vector<float> amplitudes;
+    vector<float> offsets;
+    vector<float> phases;
+    vector<float> values;
+    
+    // the edited channel
+    float seed;
+    float rate;
+    float amplitude;
+    float offset;
+    
+    ofxDatGuiFolder * channelsFolder;
+    vector<ofxDatGuiSlider *> channelSliders;
+    
+    void resizeChannels();
+    void loadChannel();
+public:
+    void setup();
+    void update();
+    void draw();
+    void addModuleParameters();
+    void onTypeSelected(ofxDatGuiMatrixEvent);
+};
+
+#endif /* DKNoiseBank_hpp */
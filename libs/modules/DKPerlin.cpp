@@ -34,7 +34,7 @@ void DKPerlin::setup()
 
 void DKPerlin::update()
 {
-    noiseValue = ofNoise(ofGetElapsedTimef() * mult, random) * amplitude + offset;
+    noiseValue = DKNoise::noise(ofGetElapsedTimef() * mult, random) * amplitude + offset;
     //valuePlotter->setValue(noiseValue);
 }
 
@@ -22,44 +22,191 @@
 
 #include "DKPreview.hpp"
 
+// each cache texel averages 4x4 bilinear taps spread over its source footprint
+static string previewDownsampleShader = STRINGIFY
+(
+ uniform SAMPLER_TYPE src;
+ uniform vec2 offset;
+ uniform vec2 scale;
+ uniform vec2 texSize;
+ 
+ void main()
+ {
+     vec2 origin = offset + floor(gl_FragCoord.xy) * scale;
+     vec2 stp = scale * 0.25;
+     vec4 sum = vec4(0.0);
+     
+     for (int y = 0; y < 4; y++)
+     {
+         for (int x = 0; x < 4; x++)
+         {
+             sum += TEXTURE_PX(src, origin + (vec2(x, y) + 0.5) * stp, texSize);
+         }
+     }
+     gl_FragColor = sum / 16.0;
+ }
+);
+
 void DKPreview::setup()
 {
     drawFbo = false;
+    cacheValid = false;
     fbo = nullptr;
     scaleX = scaleY = 0.5;
+    refreshRate = 15;
+    lastRefresh = 0;
+    lastGeneration = 0;
+    
+    downsample.setupFromSource(previewDownsampleShader);
     
     addOutputConnection(DKConnectionType::DK_FBO);
     addInputConnection(DKConnectionType::DK_FBO);
+    addInputConnection(DKConnectionType::DK_TEXTURE);
 }
 
 void DKPreview::update()
 {
+    ofFbo * source = getSource();
+    if(source == nullptr) return;
+    
+    // the view may be connected before its fbo exists, and the source or
+    // its region can change, so the cache is checked here and not only on connect
+    ofRectangle region = getSourceRegion();
+    if(!cache.isAllocated() || region != cacheRegion)
+    {
+        allocateCache();
+        cacheValid = false;
+    }
+    
+    if(!isVisible()) return;
+    
+    float now = ofGetElapsedTimef();
+    uint64_t generation = DKTexture::getGeneration(*source);
+    bool changed = generation == 0 || generation != lastGeneration;
+    
+    if(cacheValid && (!changed || now - lastRefresh < 1.0 / refreshRate)) return;
+    
+    refreshCache();
+    lastRefresh = now;
+    lastGeneration = generation;
+    cacheValid = true;
 }
 
 void DKPreview::draw()
 {
-    if(drawFbo)
+    if(getSource() != nullptr && cacheValid && cache.isAllocated())
     {
-        ofPushMatrix();
-        ofTranslate(gui->getPosition().x, gui->getPosition().y + 20);
-        ofScale(scaleX, scaleY);
-        fbo->draw(0,0);
-        ofPopMatrix();
+        cache.draw(gui->getPosition().x, gui->getPosition().y + 20);
     }
+}
+
+void DKPreview::addModuleParameters()
+{
+    addSlider("refresh rate", refreshRate, 1.0, 60.0, 15.0, 0);
+}
+
+bool DKPreview::isVisible()
+{
+    float z = getZoom();
+    ofPoint t = getTranslation();
+    ofPoint pos = gui->getPosition();
+    
+    float x = t.x + pos.x * z;
+    float y = t.y + (pos.y + 20) * z;
+    float w = cache.getWidth() * z;
+    float h = cache.getHeight() * z;
     
+    // not worth refreshing a preview that is only a few pixels wide
+    if(w < 32 || h < 18) return false;
+    
+    return x + w > 0 && y + h > 0 && x < ofGetWidth() && y < ofGetHeight();
+}
+
+ofFbo * DKPreview::getSource()
+{
+    if(view != nullptr && view->fbo != nullptr) return view->fbo;
+    return drawFbo ? fbo : nullptr;
+}
+
+ofRectangle DKPreview::getSourceRegion()
+{
+    if(view != nullptr && view->fbo != nullptr) return view->region;
+    return ofRectangle(0, 0, fbo->getWidth(), fbo->getHeight());
+}
+
+void DKPreview::refreshCache()
+{
+    ofFbo * source = getSource();
+    ofTexture & tex = source->getTexture();
+    ofRectangle region = getSourceRegion();
+    
+    cache.begin();
+    ofClear(0, 0, 0, 0);
+    ofPushStyle();
+    ofDisableAlphaBlending();
+    
+    if(DKTexture::getProfile(tex) == DKTextureProfile::DK_MIPMAP_2D)
+    {
+        int level = MAX(0, (int) floor(log2(region.width / cache.getWidth())));
+        if(region.width != tex.getWidth() || region.height != tex.getHeight())
+        {
+            tex.drawSubsection(0, 0, cache.getWidth(), cache.getHeight(), region.x, region.y, region.width, region.height);
+        }
+        else
+        {
+            DKTexture::drawMipLevel(*source, level, 0, 0, cache.getWidth(), cache.getHeight());
+        }
+    }
+    else
+    {
+        ofShader & shader = downsample.get(tex);
+        shader.begin();
+        shader.setUniformTexture("src", tex, 1);
+        shader.setUniform2f("offset", region.x, region.y);
+        shader.setUniform2f("scale", region.width / cache.getWidth(), region.height / cache.getHeight());
+        shader.setUniform2f("texSize", tex.getWidth(), tex.getHeight());
+        ofDrawRectangle(0, 0, cache.getWidth(), cache.getHeight());
+        shader.end();
+    }
+    
+    ofPopStyle();
+    cache.end();
 }
 
 void DKPreview::setFbo(ofFbo * fboPtr)
 {
     fbo  = fboPtr;
     drawFbo = fboPtr != nullptr;
+    cacheValid = false;
+    allocateCache();
+}
+
+void DKPreview::setTextureView(DKTextureView * viewPtr)
+{
+    view = viewPtr;
+    cacheValid = false;
+    allocateCache();
+}
+
+void DKPreview::allocateCache()
+{
+    if(getSource() == nullptr) return;
     
-    float scale = 2 * moduleGuiWidth/getModuleWidth();
-    float aspect = getModuleWidth()/getModuleHeight();
+    ofRectangle region = getSourceRegion();
+    cacheRegion = region;
+    float scale = 2 * moduleGuiWidth/region.width;
+    float aspect = region.width/region.height;
     scaleX = scale * 0.80 * aspect;
     scaleY = scale * 0.80 * aspect;
     
-    gui->setWidth(getModuleWidth() * scaleX);
+    gui->setWidth(region.width * scaleX);
+    
+    int cacheWidth = MAX(1, (int) round(region.width * scaleX));
+    int cacheHeight = MAX(1, (int) round(region.height * scaleY));
+    if(!cache.isAllocated() || cache.getWidth() != cacheWidth || cache.getHeight() != cacheHeight)
+    {
+        cache.allocate(DKTexture::getFboSettings(cacheWidth, cacheHeight, DKTextureProfile::DK_RECTANGLE));
+    }
 }
 
 ofFbo * DKPreview::getFbo()
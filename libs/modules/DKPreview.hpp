@@ -28,14 +28,30 @@
 class DKPreview : public DKModule{
 private:
     ofFbo * fbo;
+    DKTextureView * view = nullptr;
+    ofFbo cache;
+    ofRectangle cacheRegion;
+    DKShaderVariants downsample;
     bool drawFbo = false;
+    bool cacheValid = false;
     float scaleX;
     float scaleY;
+    float refreshRate;
+    float lastRefresh;
+    uint64_t lastGeneration;
+    
+    ofFbo * getSource();
+    ofRectangle getSourceRegion();
+    bool isVisible();
+    void refreshCache();
+    void allocateCache();
 public:
     void setup();
     void update();
     void draw();
+    void addModuleParameters();
     void setFbo(ofFbo *);
+    void setTextureView(DKTextureView *);
     ofFbo * getFbo();
 };
 
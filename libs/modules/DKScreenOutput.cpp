@@ -26,8 +26,10 @@
 void DKScreenOutput::setup()
 {
     addInputConnection(DKConnectionType::DK_FBO);
+    addInputConnection(DKConnectionType::DK_TEXTURE);
     addOutputConnection(DKConnectionType::DK_FBO);
     display = nullptr;
+    view = nullptr;
 	drawFbo = false;
 }
 
@@ -37,6 +39,11 @@ void DKScreenOutput::setFbo(ofFbo * fboPtr)
     drawFbo = fboPtr != nullptr;
 }
 
+void DKScreenOutput::setTextureView(DKTextureView * viewPtr)
+{
+    view = viewPtr;
+}
+
 ofFbo * DKScreenOutput::getFbo()
 {
     return fbo;
@@ -83,7 +90,14 @@ void DKScreenOutput::onVideoOutputChange(ofxDatGuiDropdownEvent e)
         glfwGetMonitorPos(*monitors, &xpos, &ypos);
         
         ofGLFWWindowSettings settings;
-        settings.setSize(getModuleWidth(), getModuleHeight());
+        if(view != nullptr && view->fbo != nullptr)
+        {
+            settings.setSize(view->region.width, view->region.height);
+        }
+        else
+        {
+            settings.setSize(getModuleWidth(), getModuleHeight());
+        }
         settings.setPosition(ofVec2f(xpos,ypos));
         settings.decorated = false;
         settings.resizable = false;
@@ -112,7 +126,14 @@ void DKScreenOutput::onVideoOutputChange(ofxDatGuiDropdownEvent e)
 
 void DKScreenOutput::drawDisplay(ofEventArgs & args)
 {
-    if(drawFbo)
+    if(view != nullptr && view->fbo != nullptr)
+    {
+        // present the head straight from the shared texture, no intermediate fbo
+        ofRectangle & r = view->region;
+        ofBackground(0);
+        view->fbo->getTexture().drawSubsection(0, 0, r.width, r.height, r.x, r.y, r.width, r.height);
+    }
+    else if(drawFbo)
     {
         ofBackground(0);
         fbo->draw(0,0);
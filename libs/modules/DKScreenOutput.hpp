@@ -32,6 +32,7 @@
 class DKScreenOutput : public DKModule{
 private:
     ofFbo * fbo;
+    DKTextureView * view = nullptr;
     bool drawFbo = false;
     string serverName;
     vector<string> monitorsName;
@@ -43,6 +44,7 @@ public:
 	void closeDisplay(ofEventArgs& args);
 
     void setFbo(ofFbo *);
+    void setTextureView(DKTextureView *);
     void addModuleParameters();
     ofFbo * getFbo();
     void onVideoOutputChange(ofxDatGuiDropdownEvent);
@@ -0,0 +1,222 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKCueList.hpp"
+#include "DKMediaPool.hpp"
+
+DKCueList::DKCueList()
+{
+    currentCue = pendingCue = learnCue = -1;
+}
+
+int DKCueList::capture(string name, unordered_map<string, DKModule*> & modules)
+{
+    // snapshot of what is live right now: every pool's item, the controls of
+    // top level modules and of the canvases currently shown by the pools
+    DKCue cue;
+    cue.name = name;
+    
+    for (pair<string, DKModule*> module : modules)
+    {
+        DKModule * m = module.second;
+        if (!m->getModuleEnabled()) continue;
+        
+        // a pool's own controls are its settings, not part of the scene
+        if (m->getModuleHasChild())
+        {
+            DKMediaPool * pool = static_cast<DKMediaPool*>(m);
+            int index = pool->getCurrentIndex();
+            cue.pools.push_back({ pool, index });
+            if (pool->getChildModule() != nullptr) captureComponents(cue, pool->getChildModule(), { nullptr, pool, index });
+        }
+        else if (!m->moduleIsChild) captureComponents(cue, m, { m, nullptr, -1 });
+    }
+    
+    cues.push_back(cue);
+    return cues.size() - 1;
+}
+
+void DKCueList::captureComponents(DKCue & cue, DKModule * m, DKCue::Owner owner)
+{
+    for (auto component : m->gui->getItems())
+    {
+        vector<ofxDatGuiComponent*> items = { component };
+        if (component->children.size() > 0) items = component->children;
+        for (auto item : items)
+        {
+            if (item->getType() == ofxDatGuiType::SLIDER)
+            {
+                ofxDatGuiSlider * slider = static_cast<ofxDatGuiSlider*>(item);
+                cue.sliders.push_back({ owner, slider->getName(), (float) slider->getComponentScale() });
+            }
+            else if (item->getType() == ofxDatGuiType::MATRIX)
+            {
+                ofxDatGuiMatrix * matrix = static_cast<ofxDatGuiMatrix*>(item);
+                cue.matrices.push_back({ owner, matrix->getName(), matrix->getSelected() });
+            }
+        }
+    }
+}
+
+DKModule * DKCueList::resolve(const DKCue::Owner & owner)
+{
+    if (owner.module != nullptr) return owner.module;
+    // pools are triggered first, so the canvas of the cue is the live one
+    if (owner.pool->getCurrentIndex() != owner.index) return nullptr;
+    return owner.pool->getChildModule();
+}
+
+ofxDatGuiComponent * DKCueList::findComponent(DKModule * m, ofxDatGuiType type, string name)
+{
+    for (auto component : m->gui->getItems())
+    {
+        vector<ofxDatGuiComponent*> items = { component };
+        if (component->children.size() > 0) items = component->children;
+        for (auto item : items)
+        {
+            if (item->getType() == type && item->getName() == name) return item;
+        }
+    }
+    return nullptr;
+}
+
+void DKCueList::select(ofxDatGuiMatrix * matrix, vector<int> selected)
+{
+    vector<int> previous = matrix->getSelected();
+    matrix->setSelected(selected);
+    if (matrix->matrixEventCallback == nullptr) return;
+    
+    // same events a click sends, so the owner reacts as if it was clicked
+    for (int i : previous)
+    {
+        if (std::find(selected.begin(), selected.end(), i) == selected.end())
+            matrix->matrixEventCallback(ofxDatGuiMatrixEvent(matrix, i, false));
+    }
+    for (int i : selected)
+    {
+        if (std::find(previous.begin(), previous.end(), i) == previous.end())
+            matrix->matrixEventCallback(ofxDatGuiMatrixEvent(matrix, i, true));
+    }
+}
+
+void DKCueList::trigger(int cue)
+{
+    if (cue >= 0 && cue < cues.size()) pendingCue = cue;
+}
+
+void DKCueList::triggerNext()
+{
+    if (cues.empty()) return;
+    trigger((currentCue + 1) % cues.size());
+}
+
+void DKCueList::prefetch(int cue)
+{
+    if (cue < 0 || cue >= cues.size()) return;
+    for (auto & target : cues[cue].pools) target.pool->prepareStandby(target.index);
+}
+
+void DKCueList::apply()
+{
+    if (pendingCue < 0) return;
+    
+    DKCue & cue = cues[pendingCue];
+    for (auto & target : cue.pools)
+    {
+        if (target.index != target.pool->getCurrentIndex()) target.pool->triggerPoolMedia(target.index);
+    }
+    for (auto & target : cue.sliders)
+    {
+        DKModule * m = resolve(target.owner);
+        if (m == nullptr) continue;
+        auto slider = findComponent(m, ofxDatGuiType::SLIDER, target.name);
+        if (slider != nullptr) static_cast<ofxDatGuiSlider*>(slider)->setComponentScale(target.scale);
+    }
+    for (auto & target : cue.matrices)
+    {
+        DKModule * m = resolve(target.owner);
+        if (m == nullptr) continue;
+        auto matrix = findComponent(m, ofxDatGuiType::MATRIX, target.name);
+        if (matrix != nullptr) select(static_cast<ofxDatGuiMatrix*>(matrix), target.selected);
+    }
+    
+    currentCue = pendingCue;
+    pendingCue = -1;
+    // pools that are still crossfading hold the prefetch until the fade ends
+    prefetch((currentCue + 1) % cues.size());
+}
+
+void DKCueList::remove(DKModule * m)
+{
+    // called before a module is deleted so no cue keeps a dangling pointer.
+    // an evicted canvas is not one of them, its pool rebuilds it on demand.
+    auto owned = [m](const DKCue::Owner & o) { return o.module == m || (DKModule*) o.pool == m; };
+    for (auto & cue : cues)
+    {
+        cue.pools.erase(std::remove_if(cue.pools.begin(), cue.pools.end(),
+            [m](const DKCue::PoolTarget & t) { return (DKModule*) t.pool == m; }), cue.pools.end());
+        cue.sliders.erase(std::remove_if(cue.sliders.begin(), cue.sliders.end(),
+            [owned](const DKCue::SliderTarget & t) { return owned(t.owner); }), cue.sliders.end());
+        cue.matrices.erase(std::remove_if(cue.matrices.begin(), cue.matrices.end(),
+            [owned](const DKCue::MatrixTarget & t) { return owned(t.owner); }), cue.matrices.end());
+    }
+}
+
+void DKCueList::clear()
+{
+    cues.clear();
+    midiMappings.clear();
+    currentCue = pendingCue = learnCue = -1;
+}
+
+void DKCueList::armLearn()
+{
+    learnCue = cues.size() - 1;
+}
+
+bool DKCueList::isLearning()
+{
+    return learnCue >= 0;
+}
+
+void DKCueList::learn(int key)
+{
+    if (learnCue < 0) return;
+    midiMappings[key] = learnCue;
+    learnCue = -1;
+}
+
+int DKCueList::getNumCues()
+{
+    return cues.size();
+}
+
+int DKCueList::getCurrentCue()
+{
+    return currentCue;
+}
+
+string DKCueList::getCueName(int cue)
+{
+    return cues[cue].name;
+}
@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKCueList_hpp
+#define DKCueList_hpp
+
+#include "ofMain.h"
+#include "ofxDatGui.h"
+
+class DKModule;
+class DKMediaPool;
+
+// A scene change: the item every pool switches to, the value of every slider
+// and the selection of every matrix (mixer blend modes).
+struct DKCue
+{
+    struct PoolTarget
+    {
+        DKMediaPool * pool;
+        int index;
+    };
+    
+    // a top level module, or the canvas at index of a pool. Pools evict and
+    // rebuild canvases, so their controls are looked up by name on apply.
+    struct Owner
+    {
+        DKModule * module;
+        DKMediaPool * pool;
+        int index;
+    };
+    
+    struct SliderTarget
+    {
+        Owner owner;
+        string name;
+        float scale;
+    };
+    
+    struct MatrixTarget
+    {
+        Owner owner;
+        string name;
+        vector<int> selected;
+    };
+    
+    string name;
+    vector<PoolTarget> pools;
+    vector<SliderTarget> sliders;
+    vector<MatrixTarget> matrices;
+};
+
+// Cues are triggered from anywhere (midi, keys) but only applied in apply(),
+// which runs before any module updates, so every pool and slider of a cue
+// changes on the same frame. The cue after the last one applied is kept
+// warm in the pools' standby slots.
+class DKCueList
+{
+public:
+    DKCueList();
+    
+    int capture(string, unordered_map<string, DKModule*> &);
+    void trigger(int);
+    void triggerNext();
+    void prefetch(int);
+    void apply();
+    void remove(DKModule *);
+    void clear();
+    
+    void armLearn();
+    bool isLearning();
+    void learn(int);
+    
+    int getNumCues();
+    int getCurrentCue();
+    string getCueName(int);
+    // packed midi key (see DKMidiDispatch::pack) -> cue
+    unordered_map<int, int> midiMappings;
+    
+private:
+    void captureComponents(DKCue &, DKModule *, DKCue::Owner);
+    DKModule * resolve(const DKCue::Owner &);
+    ofxDatGuiComponent * findComponent(DKModule *, ofxDatGuiType, string);
+    void select(ofxDatGuiMatrix *, vector<int>);
+    
+    vector<DKCue> cues;
+    int currentCue;
+    int pendingCue;
+    int learnCue;
+};
+
+#endif /* DKCueList_hpp */
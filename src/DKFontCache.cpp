@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKFontCache.hpp"
+
+map<DKFontCache::Key, weak_ptr<ofTrueTypeFont>> DKFontCache::fonts;
+
+shared_ptr<ofTrueTypeFont> DKFontCache::get(string file, int size, bool antialiased, bool fullCharacterSet)
+{
+    Key key = make_tuple(file, size, antialiased, fullCharacterSet);
+    
+    auto it = fonts.find(key);
+    if (it != fonts.end())
+    {
+        shared_ptr<ofTrueTypeFont> font = it->second.lock();
+        if (font) return font;
+    }
+    
+    shared_ptr<ofTrueTypeFont> font = make_shared<ofTrueTypeFont>();
+    if (!font->load(file, size, antialiased, fullCharacterSet))
+    {
+        ofLogWarning("DKFontCache") << "couldn't load " << file;
+    }
+    fonts[key] = font;
+    return font;
+}
+
+void DKTextBatch::setFont(shared_ptr<ofTrueTypeFont> f)
+{
+    font = f;
+    clear();
+}
+
+void DKTextBatch::add(const string & text, float x, float y, ofColor color)
+{
+    if (font == nullptr || !font->isLoaded()) return;
+    
+    const ofMesh & glyphs = font->getStringMesh(text, x, y, ofGetCurrentRenderer()->isVFlipped());
+    ofIndexType offset = mesh.getNumVertices();
+    
+    mesh.addVertices(glyphs.getVertices());
+    mesh.addTexCoords(glyphs.getTexCoords());
+    for (int i = 0; i < glyphs.getNumVertices(); i++) mesh.addColor(color);
+    for (auto index : glyphs.getIndices()) mesh.addIndex(offset + index);
+}
+
+void DKTextBatch::draw()
+{
+    if (mesh.getNumVertices() == 0) return;
+    
+    mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+    font->getFontTexture().bind();
+    mesh.draw();
+    font->getFontTexture().unbind();
+}
+
+void DKTextBatch::clear()
+{
+    mesh.clear();
+}
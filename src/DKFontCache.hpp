@@ -0,0 +1,56 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKFontCache_hpp
+#define DKFontCache_hpp
+
+#include "ofMain.h"
+
+// Process wide cache of loaded fonts keyed by (file, size, flags). Every
+// caller asking for the same face shares one glyph atlas, which is freed
+// once the last shared_ptr to it goes away.
+class DKFontCache
+{
+public:
+    static shared_ptr<ofTrueTypeFont> get(string, int, bool, bool);
+    
+private:
+    typedef tuple<string, int, bool, bool> Key;
+    static map<Key, weak_ptr<ofTrueTypeFont>> fonts;
+};
+
+// Strings collected during a frame and drawn as one mesh with the font atlas bound.
+class DKTextBatch
+{
+public:
+    void setFont(shared_ptr<ofTrueTypeFont>);
+    void add(const string &, float, float, ofColor);
+    void draw();
+    void clear();
+    
+private:
+    shared_ptr<ofTrueTypeFont> font;
+    ofMesh mesh;
+};
+
+#endif /* DKFontCache_hpp */
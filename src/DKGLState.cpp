@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKGLState.hpp"
+
+// -1 means unknown, the next request is always applied
+int DKGLState::depthTest = -1;
+int DKGLState::lighting = -1;
+int DKGLState::smoothing = -1;
+
+bool DKGLState::filter(int & cached, int value)
+{
+    if (cached == value) return false;
+    cached = value;
+    return true;
+}
+
+void DKGLState::setDepthTest(bool enabled)
+{
+    if (!filter(depthTest, enabled)) return;
+    if (enabled) ofEnableDepthTest();
+    else ofDisableDepthTest();
+}
+
+void DKGLState::setLighting(bool enabled)
+{
+    if (!filter(lighting, enabled)) return;
+    if (enabled) ofEnableLighting();
+    else ofDisableLighting();
+}
+
+void DKGLState::setSmoothing(bool enabled)
+{
+    if (!filter(smoothing, enabled)) return;
+    if (enabled) ofEnableSmoothing();
+    else ofDisableSmoothing();
+}
+
+void DKGLState::invalidate()
+{
+    depthTest = lighting = smoothing = -1;
+}
@@ -0,0 +1,49 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKGLState_hpp
+#define DKGLState_hpp
+
+#include "ofMain.h"
+
+// Tracks the depth test, lighting and smoothing toggles DarkKnight makes
+// around lit canvases. A request for the state already set since the last
+// invalidate() is skipped. Modules and ofPushStyle/ofPopStyle change GL state
+// behind the tracker, so it is forgotten at the start of update and draw.
+class DKGLState
+{
+public:
+    static void setDepthTest(bool);
+    static void setLighting(bool);
+    static void setSmoothing(bool);
+    static void invalidate();
+    
+private:
+    static bool filter(int &, int);
+    
+    static int depthTest;
+    static int lighting;
+    static int smoothing;
+};
+
+#endif /* DKGLState_hpp */
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKGpuTimer.hpp"
+
+DKGpuTimer::DKGpuTimer()
+{
+    writeIndex = readIndex = 0;
+    active = initialized = supported = false;
+    for (int i = 0; i < numQueries; i++) pending[i] = false;
+}
+
+DKGpuTimer::~DKGpuTimer()
+{
+    if (initialized && supported) glDeleteQueries(numQueries, queries);
+}
+
+void DKGpuTimer::setup()
+{
+    initialized = true;
+    supported = ofGLCheckExtension("GL_ARB_timer_query") || ofGLCheckExtension("GL_EXT_timer_query");
+    if (supported) glGenQueries(numQueries, queries);
+}
+
+void DKGpuTimer::begin()
+{
+    if (!initialized) setup();
+    
+    // every slot still in flight: skip this measurement instead of waiting
+    active = supported && !pending[writeIndex];
+    if (active) glBeginQuery(GL_TIME_ELAPSED, queries[writeIndex]);
+}
+
+void DKGpuTimer::end()
+{
+    if (!active) return;
+    
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[writeIndex] = true;
+    writeIndex = (writeIndex + 1) % numQueries;
+    active = false;
+}
+
+bool DKGpuTimer::pollResult(float & millis)
+{
+    if (!supported || !pending[readIndex]) return false;
+    
+    GLint available = 0;
+    glGetQueryObjectiv(queries[readIndex], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+    
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(queries[readIndex], GL_QUERY_RESULT, &elapsed);
+    pending[readIndex] = false;
+    readIndex = (readIndex + 1) % numQueries;
+    
+    millis = elapsed / 1000000.0;
+    return true;
+}
+
+bool DKGpuTimer::isSupported()
+{
+    if (!initialized) setup();
+    return supported;
+}
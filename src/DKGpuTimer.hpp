@@ -0,0 +1,56 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKGpuTimer_hpp
+#define DKGpuTimer_hpp
+
+#include "ofMain.h"
+
+// GL_TIME_ELAPSED queries kept in a small ring. Results are collected a few
+// frames later with pollResult() so measuring never stalls the pipeline.
+// Without timer query support begin()/end() do nothing.
+class DKGpuTimer
+{
+public:
+    DKGpuTimer();
+    ~DKGpuTimer();
+    
+    void begin();
+    void end();
+    bool pollResult(float &);
+    bool isSupported();
+    
+private:
+    void setup();
+    
+    static const int numQueries = 8;
+    GLuint queries[numQueries];
+    bool pending[numQueries];
+    int writeIndex;
+    int readIndex;
+    bool active;
+    bool initialized;
+    bool supported;
+};
+
+#endif /* DKGpuTimer_hpp */
@@ -0,0 +1,360 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKLfoEngine.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+DKLfoEngine & DKLfoEngine::get()
+{
+    static DKLfoEngine engine;
+    return engine;
+}
+
+DKLfoEngine::DKLfoEngine()
+{
+    startTicks = std::chrono::steady_clock::now().time_since_epoch().count();
+    tempo = 120;
+    beatOrigin = 0;
+    tempoTime = 0;
+    lastTime = 0;
+    evaluationRate = 60;
+    
+    randomValues.resize(randomSize);
+    for (auto & r : randomValues) r = ofRandom(0, 1);
+    
+    buildTables();
+}
+
+// fourier series of each wave, level L keeps the first 2^L harmonics;
+// sigma factors soften the ringing at the edges of square and ramps
+void DKLfoEngine::buildTables()
+{
+    const int numWaves = (int) DKLfoWave::DK_RANDOM;
+    tables.resize(numWaves * tableLevels * (tableSize + 1));
+    
+    for (int w = 0; w < numWaves; w++)
+    {
+        DKLfoWave wave = (DKLfoWave) w;
+        for (int level = 0; level < tableLevels; level++)
+        {
+            int harmonics = 1 << level;
+            float * table = tables.data() + (w * tableLevels + level) * (tableSize + 1);
+            
+            for (int n = 0; n < tableSize; n++)
+            {
+                double t = (double) n / tableSize;
+                double sum = 0;
+                if (wave == DKLfoWave::DK_SINE)
+                {
+                    sum = -cos(TWO_PI * t);
+                }
+                else for (int k = 1; k <= harmonics; k++)
+                {
+                    double x = PI * k / (harmonics + 1);
+                    double sigma = sin(x) / x;
+                    if (wave == DKLfoWave::DK_TRIANGLE && k % 2 == 1)
+                        sum -= sigma * cos(TWO_PI * k * t) / (k * k);
+                    else if (wave == DKLfoWave::DK_SQUARE && k % 2 == 1)
+                        sum -= sigma * sin(TWO_PI * k * t) / k;
+                    else if (wave == DKLfoWave::DK_RAMP_UP)
+                        sum -= sigma * sin(TWO_PI * k * t) / k;
+                    else if (wave == DKLfoWave::DK_RAMP_DOWN)
+                        sum += sigma * sin(TWO_PI * k * t) / k;
+                }
+                table[n] = sum;
+            }
+            
+            // rescale to [0, 1], the extra entry wraps for interpolation
+            float low = *min_element(table, table + tableSize);
+            float high = *max_element(table, table + tableSize);
+            for (int n = 0; n < tableSize; n++) table[n] = (table[n] - low) / (high - low);
+            table[tableSize] = table[0];
+        }
+    }
+}
+
+int DKLfoEngine::add()
+{
+    for (int i = 0; i < (int) used.size(); i++)
+    {
+        if (!used[i])
+        {
+            used[i] = true;
+            cycles[i] = 0;
+            return i;
+        }
+    }
+    
+    used.push_back(true);
+    waves.push_back(DKLfoWave::DK_SINE);
+    rates.push_back(1);
+    synced.push_back(false);
+    phaseOffsets.push_back(0);
+    amplitudes.push_back(1);
+    offsets.push_back(0);
+    cycles.push_back(0);
+    for (int k = 0; k < numOutputs; k++) sliders.push_back(nullptr);
+    return used.size() - 1;
+}
+
+void DKLfoEngine::remove(int slot)
+{
+    if (slot < 0 || slot >= (int) used.size()) return;
+    used[slot] = false;
+    rates[slot] = 0;
+    amplitudes[slot] = 0;
+    offsets[slot] = 0;
+    cycles[slot] = 0;
+    for (int k = 0; k < numOutputs; k++) sliders[slot * numOutputs + k] = nullptr;
+}
+
+void DKLfoEngine::set(int slot, DKLfoWave wave, float rate, bool sync, float phase, float amplitude, float offset)
+{
+    waves[slot] = wave;
+    rates[slot] = rate;
+    synced[slot] = sync;
+    phaseOffsets[slot] = phase;
+    amplitudes[slot] = amplitude;
+    offsets[slot] = offset;
+}
+
+void DKLfoEngine::setOutput(int slot, int output, ofxDatGuiSlider * slider)
+{
+    sliders[slot * numOutputs + output] = slider;
+}
+
+float DKLfoEngine::getValue(int slot, int output)
+{
+    // lfos added since the last evaluate have no values yet
+    if (values.size() != numOutputs * used.size()) return 0;
+    return values[output * used.size() + slot];
+}
+
+// the wave at any moment, ahead of or between evaluations
+float DKLfoEngine::sample(int slot, int output, double seconds)
+{
+    double c = synced[slot] ? getBeats(seconds) * rates[slot] : cycles[slot] + rates[slot] * (seconds - lastTime);
+    return lookup(slot, c + phaseOffsets[slot] + output * 0.25) * amplitudes[slot] + offsets[slot];
+}
+
+void DKLfoEngine::setTempo(float bpm)
+{
+    double now = getSeconds();
+    beatOrigin = getBeats(now);
+    tempoTime = now;
+    tempo = bpm;
+}
+
+float DKLfoEngine::getTempo()
+{
+    return tempo;
+}
+
+void DKLfoEngine::resync()
+{
+    beatOrigin = 0;
+    tempoTime = getSeconds();
+}
+
+double DKLfoEngine::getSeconds()
+{
+    uint64_t ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+    return (ticks - startTicks) * (double) std::chrono::steady_clock::period::num / std::chrono::steady_clock::period::den;
+}
+
+double DKLfoEngine::getBeats()
+{
+    return getBeats(getSeconds());
+}
+
+double DKLfoEngine::getBeats(double seconds)
+{
+    return beatOrigin + (seconds - tempoTime) * tempo / 60.0;
+}
+
+float DKLfoEngine::cyclesPerSecond(int slot)
+{
+    return synced[slot] ? rates[slot] * tempo / 60.0 : rates[slot];
+}
+
+// richest table whose top harmonic stays under half the evaluation rate
+int DKLfoEngine::tableBase(int slot)
+{
+    if (waves[slot] == DKLfoWave::DK_RANDOM) return -1;
+    float harmonics = 0.5 * evaluationRate / max(fabs(cyclesPerSecond(slot)), 0.001f);
+    int level = ofClamp(floor(log2(max(harmonics, 1.0f))), 0, tableLevels - 1);
+    return ((int) waves[slot] * tableLevels + level) * (tableSize + 1);
+}
+
+float DKLfoEngine::lookup(int slot, double c)
+{
+    double cycle = floor(c);
+    float phase = c - cycle;
+    int base = tableBase(slot);
+    if (base < 0) return randomValues[(int64_t) cycle & (randomSize - 1)];
+    
+    float position = phase * tableSize;
+    int index = min((int) position, tableSize - 1);
+    float t = position - index;
+    float a = tables[base + index];
+    return a + t * (tables[base + index + 1] - a);
+}
+
+void DKLfoEngine::evaluate()
+{
+    evaluate(getSeconds());
+}
+
+void DKLfoEngine::evaluate(double seconds)
+{
+    double dt = max(seconds - lastTime, 0.0);
+    if (dt > 0) evaluationRate = ofLerp(evaluationRate, 1.0 / dt, 0.1);
+    lastTime = seconds;
+    
+    int n = used.size();
+    phases.resize(n);
+    cycleIndices.resize(n);
+    bases.resize(n);
+    values.resize(numOutputs * n);
+    
+    // phases are kept in double here, long sessions would drift in float
+    double beats = getBeats(seconds);
+    for (int i = 0; i < n; i++)
+    {
+        if (synced[i]) cycles[i] = beats * rates[i];
+        else cycles[i] += rates[i] * dt;
+        
+        double c = cycles[i] + phaseOffsets[i];
+        double cycle = floor(c);
+        phases[i] = c - cycle;
+        cycleIndices[i] = (int64_t) cycle & (randomSize - 1);
+        bases[i] = tableBase(i);
+    }
+    
+    for (int k = 0; k < numOutputs; k++)
+    {
+        float * out = values.data() + k * n;
+        float shift = k * 0.25;
+        int i = 0;
+#if defined(__AVX2__)
+        const __m256i lastIndex = _mm256_set1_epi32(tableSize - 1);
+        const __m256i randomMask = _mm256_set1_epi32(randomSize - 1);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i zero = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 phase = _mm256_add_ps(_mm256_loadu_ps(phases.data() + i), _mm256_set1_ps(shift));
+            __m256 wrap = _mm256_floor_ps(phase);
+            phase = _mm256_sub_ps(phase, wrap);
+            __m256i cycle = _mm256_add_epi32(_mm256_loadu_si256((__m256i *) (cycleIndices.data() + i)), _mm256_cvttps_epi32(wrap));
+            cycle = _mm256_and_si256(cycle, randomMask);
+            
+            __m256i base = _mm256_loadu_si256((__m256i *) (bases.data() + i));
+            __m256 isRandom = _mm256_castsi256_ps(_mm256_cmpgt_epi32(zero, base));
+            base = _mm256_max_epi32(base, zero);
+            
+            __m256 position = _mm256_mul_ps(phase, _mm256_set1_ps(tableSize));
+            __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(position), lastIndex);
+            __m256 t = _mm256_sub_ps(position, _mm256_cvtepi32_ps(index));
+            index = _mm256_add_epi32(base, index);
+            __m256 a = _mm256_i32gather_ps(tables.data(), index, 4);
+            __m256 b = _mm256_i32gather_ps(tables.data(), _mm256_add_epi32(index, one), 4);
+            __m256 v = _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+            v = _mm256_blendv_ps(v, _mm256_i32gather_ps(randomValues.data(), cycle, 4), isRandom);
+            
+            v = _mm256_add_ps(_mm256_mul_ps(v, _mm256_loadu_ps(amplitudes.data() + i)), _mm256_loadu_ps(offsets.data() + i));
+            _mm256_storeu_ps(out + i, v);
+        }
+#elif defined(__ARM_NEON)
+        // no gather instruction, the table reads stay scalar
+        for (; i + 4 <= n; i += 4)
+        {
+            // phases and shift are never negative, truncation is the floor
+            float32x4_t phase = vaddq_f32(vld1q_f32(phases.data() + i), vdupq_n_f32(shift));
+            int32x4_t wrap = vcvtq_s32_f32(phase);
+            phase = vsubq_f32(phase, vcvtq_f32_s32(wrap));
+            
+            float32x4_t position = vmulq_f32(phase, vdupq_n_f32(tableSize));
+            int32x4_t index = vminq_s32(vcvtq_s32_f32(position), vdupq_n_s32(tableSize - 1));
+            float32x4_t t = vsubq_f32(position, vcvtq_f32_s32(index));
+            
+            int32_t wraps[4], indices[4];
+            float a[4], b[4];
+            vst1q_s32(wraps, wrap);
+            vst1q_s32(indices, index);
+            for (int l = 0; l < 4; l++)
+            {
+                int j = i + l;
+                if (bases[j] < 0)
+                {
+                    a[l] = b[l] = randomValues[(cycleIndices[j] + wraps[l]) & (randomSize - 1)];
+                }
+                else
+                {
+                    a[l] = tables[bases[j] + indices[l]];
+                    b[l] = tables[bases[j] + indices[l] + 1];
+                }
+            }
+            float32x4_t va = vld1q_f32(a);
+            float32x4_t v = vaddq_f32(va, vmulq_f32(t, vsubq_f32(vld1q_f32(b), va)));
+            v = vaddq_f32(vmulq_f32(v, vld1q_f32(amplitudes.data() + i)), vld1q_f32(offsets.data() + i));
+            vst1q_f32(out + i, v);
+        }
+#endif
+        for (; i < n; i++)
+        {
+            float phase = phases[i] + shift;
+            float wrap = floorf(phase);
+            phase -= wrap;
+            float v;
+            if (bases[i] < 0)
+            {
+                v = randomValues[(cycleIndices[i] + (int) wrap) & (randomSize - 1)];
+            }
+            else
+            {
+                float position = phase * tableSize;
+                int index = min((int) position, tableSize - 1);
+                float t = position - index;
+                float a = tables[bases[i] + index];
+                v = a + t * (tables[bases[i] + index + 1] - a);
+            }
+            out[i] = v * amplitudes[i] + offsets[i];
+        }
+    }
+    
+    for (int i = 0; i < n; i++)
+    {
+        if (!used[i]) continue;
+        for (int k = 0; k < numOutputs; k++)
+        {
+            ofxDatGuiSlider * slider = sliders[i * numOutputs + k];
+            if (slider != nullptr) slider->setValue(values[k * n + i], false);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+
+#ifndef DKLfoEngine_hpp
+#define DKLfoEngine_hpp
+
+#include "ofMain.h"
+#include "ofxDatGui.h"
+
+enum class DKLfoWave {
+    DK_SINE,
+    DK_TRIANGLE,
+    DK_SQUARE,
+    DK_RAMP_UP,
+    DK_RAMP_DOWN,
+    DK_RANDOM
+};
+
+// Every LFO in the patch lives here and is evaluated in one batch, on a
+// clock of its own instead of the frame counter. Synced LFOs run in cycles
+// per beat of the shared tempo, free ones in cycles per second. Each LFO has
+// four outputs a quarter cycle apart (0, 90, 180 and 270 degrees), all in
+// [0, 1] before amplitude and offset.
+//
+// Waves are read from band-limited wavetables: each wave keeps one table per
+// octave of harmonics and an LFO reads the richest one that stays below half
+// the evaluation rate, so fast LFOs don't alias against the frame rate.
+// evaluate() reads the clock at the moment it runs and pushes the outputs to
+// their sliders; sample() gives the value at any other time.
+class DKLfoEngine
+{
+public:
+    static const int numOutputs = 4;
+    
+    static DKLfoEngine & get();
+    
+    int add();
+    void remove(int);
+    void set(int, DKLfoWave, float, bool, float, float, float);
+    void setOutput(int, int, ofxDatGuiSlider *);
+    
+    float getValue(int, int);
+    float sample(int, int, double);
+    
+    void setTempo(float);
+    float getTempo();
+    // the current moment becomes beat 0
+    void resync();
+    double getSeconds();
+    double getBeats();
+    double getBeats(double);
+    
+    void evaluate();
+    void evaluate(double);
+    
+private:
+    DKLfoEngine();
+    
+    void buildTables();
+    float cyclesPerSecond(int);
+    int tableBase(int);
+    float lookup(int, double);
+    
+    static const int tableSize = 512;
+    static const int tableLevels = 7;
+    static const int randomSize = 256;
+    
+    vector<float> tables;
+    vector<float> randomValues;
+    
+    uint64_t startTicks;
+    double beatOrigin;
+    double tempoTime;
+    float tempo;
+    double lastTime;
+    float evaluationRate;
+    
+    // one entry per lfo, slots are reused after remove
+    vector<bool> used;
+    vector<DKLfoWave> waves;
+    vector<float> rates;
+    vector<bool> synced;
+    vector<float> phaseOffsets;
+    vector<float> amplitudes;
+    vector<float> offsets;
+    vector<double> cycles;
+    vector<ofxDatGuiSlider *> sliders;
+    
+    // filled by evaluate, batch friendly
+    vector<float> phases;
+    vector<int> cycleIndices;
+    vector<int> bases;
+    vector<float> values;
+};
+
+#endif /* DKLfoEngine_hpp */
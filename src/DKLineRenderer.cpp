@@ -0,0 +1,262 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+
+#include "DKLineRenderer.hpp"
+#include "DKGLState.hpp"
+
+// generic attributes that alias no fixed function array
+#define DK_SEGMENT_START 6
+#define DK_SEGMENT_END 7
+#define DK_SEGMENT_COLOR 8
+
+// gl_Vertex.x picks the end of the segment, gl_Vertex.y the side. The quad
+// is pushed out by half the width plus a pixel of feather, caps included.
+// lineCoord holds the pixel position inside the quad (across, along and the
+// length), premultiplied by w so it interpolates linearly on screen.
+static string lineVertShader = STRINGIFY(
+    attribute vec3 segmentStart;
+    attribute vec3 segmentEnd;
+    attribute vec4 segmentColor;
+    uniform vec2 viewport;
+    uniform float lineWidth;
+    varying vec4 lineCoord;
+    
+    void main()
+    {
+        vec4 p0 = gl_ModelViewProjectionMatrix * vec4(linePosition(segmentStart), 1.0);
+        vec4 p1 = gl_ModelViewProjectionMatrix * vec4(linePosition(segmentEnd), 1.0);
+        vec2 s0 = p0.xy / p0.w * viewport * 0.5;
+        vec2 s1 = p1.xy / p1.w * viewport * 0.5;
+        float len = length(s1 - s0);
+        vec2 dir = len > 0.0001 ? (s1 - s0) / len : vec2(1.0, 0.0);
+        vec2 normal = vec2(-dir.y, dir.x);
+        
+        float extent = lineWidth * 0.5 + 1.0;
+        float side = gl_Vertex.y;
+        float along = gl_Vertex.x * 2.0 - 1.0;
+        vec4 p = gl_Vertex.x < 0.5 ? p0 : p1;
+        p.xy += (normal * side + dir * along) * extent / viewport * 2.0 * p.w;
+        gl_Position = p;
+        
+        lineCoord = vec4(side * extent, gl_Vertex.x * len + along * extent, len, 1.0) * p.w;
+        gl_FrontColor = gl_Color * segmentColor;
+    }
+);
+
+// coverage from the distance to the segment's rectangle, square caps
+static string lineFragShader = STRINGIFY(
+    uniform float lineWidth;
+    varying vec4 lineCoord;
+    
+    void main()
+    {
+        vec3 coord = lineCoord.xyz / lineCoord.w;
+        float halfWidth = lineWidth * 0.5;
+        float across = abs(coord.x) - halfWidth;
+        float along = max(-coord.y, coord.y - coord.z) - halfWidth;
+        float coverage = clamp(0.5 - max(across, along), 0.0, 1.0);
+        gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * coverage);
+    }
+);
+
+static string linePositionIdentity = STRINGIFY(
+    vec3 linePosition(vec3 p)
+    {
+        return p;
+    }
+);
+
+DKLineRenderer::DKLineRenderer()
+{
+    program = nullptr;
+    instancing = false;
+    staticMode = false;
+    numSegments = 0;
+    numCorners = 0;
+}
+
+void DKLineRenderer::setup()
+{
+    setup(linePositionIdentity);
+}
+
+void DKLineRenderer::setup(string positionSource)
+{
+    instancing = ofGLCheckExtension("GL_ARB_instanced_arrays") && ofGLCheckExtension("GL_ARB_draw_instanced");
+    
+    shader.bindAttribute(DK_SEGMENT_START, "segmentStart");
+    shader.bindAttribute(DK_SEGMENT_END, "segmentEnd");
+    shader.bindAttribute(DK_SEGMENT_COLOR, "segmentColor");
+    shader.setupFromSource(positionSource + lineVertShader, lineFragShader);
+    
+    if (instancing)
+    {
+        float corners[] = { 0, -1, 0, 1, 1, -1, 1, 1 };
+        quad.setVertexData(corners, 2, 4, GL_STATIC_DRAW);
+    }
+    stream.allocate(1024 * sizeof(DKLineSegment) * (instancing ? 1 : 4));
+}
+
+DKLineSegment * DKLineRenderer::map(int capacity)
+{
+    if (!instancing)
+    {
+        staging.resize(capacity);
+        return staging.data();
+    }
+    stream.reserve(capacity * sizeof(DKLineSegment));
+    return stream.map<DKLineSegment>();
+}
+
+void DKLineRenderer::unmap(int count)
+{
+    numSegments = count;
+    staticMode = false;
+    if (!instancing)
+    {
+        reserveCorners(count);
+        stream.reserve(count * 4 * sizeof(DKLineSegment));
+        expand(staging.data(), count, stream.map<DKLineSegment>());
+    }
+    stream.unmap();
+}
+
+void DKLineRenderer::write(const vector<DKLineSegment> & segments)
+{
+    DKLineSegment * out = map(segments.size());
+    copy(segments.begin(), segments.end(), out);
+    unmap(segments.size());
+}
+
+void DKLineRenderer::setSegments(const vector<DKLineSegment> & segments)
+{
+    numSegments = segments.size();
+    staticMode = true;
+    if (numSegments == 0) return;
+    
+    if (instancing)
+    {
+        staticSegments.allocate(numSegments * sizeof(DKLineSegment), segments.data(), GL_STATIC_DRAW);
+    }
+    else
+    {
+        reserveCorners(numSegments);
+        vector<DKLineSegment> expanded(numSegments * 4);
+        expand(segments.data(), numSegments, expanded.data());
+        staticSegments.allocate(expanded.size() * sizeof(DKLineSegment), expanded.data(), GL_STATIC_DRAW);
+    }
+}
+
+// fallback only: four corners and two triangles per segment
+void DKLineRenderer::reserveCorners(int count)
+{
+    if (count <= numCorners) return;
+    numCorners = max(count, numCorners + numCorners / 2);
+    
+    vector<float> corners;
+    vector<ofIndexType> indices;
+    corners.reserve(numCorners * 8);
+    indices.reserve(numCorners * 6);
+    for (int i = 0; i < numCorners; i++)
+    {
+        corners.insert(corners.end(), { 0, -1, 0, 1, 1, -1, 1, 1 });
+        ofIndexType v = i * 4;
+        indices.insert(indices.end(), { v, v + 1, v + 2, v + 2, v + 1, v + 3 });
+    }
+    quad.setVertexData(corners.data(), 2, numCorners * 4, GL_STATIC_DRAW);
+    quad.setIndexData(indices.data(), indices.size(), GL_STATIC_DRAW);
+}
+
+void DKLineRenderer::expand(const DKLineSegment * in, int count, DKLineSegment * out)
+{
+    for (int i = 0; i < count; i++)
+    {
+        for (int k = 0; k < 4; k++) out[i * 4 + k] = in[i];
+    }
+}
+
+void DKLineRenderer::attach(ofBufferObject & buffer, size_t offset)
+{
+    int stride = sizeof(DKLineSegment);
+    quad.setAttributeBuffer(DK_SEGMENT_START, buffer, 3, stride, offset);
+    quad.setAttributeBuffer(DK_SEGMENT_END, buffer, 3, stride, offset + sizeof(glm::vec3));
+    quad.setAttributeBuffer(DK_SEGMENT_COLOR, buffer, 4, stride, offset + 2 * sizeof(glm::vec3));
+    if (instancing)
+    {
+        quad.setAttributeDivisor(DK_SEGMENT_START, 1);
+        quad.setAttributeDivisor(DK_SEGMENT_END, 1);
+        quad.setAttributeDivisor(DK_SEGMENT_COLOR, 1);
+    }
+}
+
+ofShader & DKLineRenderer::begin(float width)
+{
+    return use(shader.get(), width);
+}
+
+// for a linePosition that samples a texture
+ofShader & DKLineRenderer::begin(float width, ofFbo & fbo)
+{
+    return use(shader.get(fbo), width);
+}
+
+ofShader & DKLineRenderer::use(ofShader & variant, float width)
+{
+    program = &variant;
+    program->begin();
+    ofRectangle viewport = ofGetCurrentViewport();
+    program->setUniform2f("viewport", viewport.width, viewport.height);
+    program->setUniform1f("lineWidth", width);
+    return *program;
+}
+
+void DKLineRenderer::draw()
+{
+    if (numSegments == 0) return;
+    
+    if (staticMode) attach(staticSegments, 0);
+    else attach(stream.getBuffer(), stream.getOffset());
+    
+    if (instancing) quad.drawInstanced(GL_TRIANGLE_STRIP, 0, 4, numSegments);
+    else quad.drawElements(GL_TRIANGLES, numSegments * 6);
+}
+
+void DKLineRenderer::end()
+{
+    program->end();
+    // the region drawn can be rewritten once the gpu passed this point
+    if (!staticMode) stream.fence();
+}
+
+void DKLineRenderer::draw(float width)
+{
+    begin(width);
+    draw();
+    end();
+}
+
+int DKLineRenderer::getNumSegments()
+{
+    return numSegments;
+}
@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+
+#ifndef DKLineRenderer_hpp
+#define DKLineRenderer_hpp
+
+#include "ofMain.h"
+#include "DKTexture.hpp"
+#include "DKStreamBuffer.hpp"
+
+struct DKLineSegment
+{
+    glm::vec3 start;
+    glm::vec3 end;
+    ofFloatColor color;
+};
+
+// Wide, anti-aliased lines without glLineWidth. Every segment becomes a
+// screen-space quad in the vertex shader and the fragment shader fades its
+// edges by the pixel distance to the segment, so all the segments of a
+// buffer go out in one instanced draw at any width. Segments are either
+// written every frame straight into GL memory or uploaded once:
+//
+//   DKLineSegment * out = lines.map(capacity);  ...write n...  lines.unmap(n);
+//   lines.draw(width);
+//
+// setup(string) takes GLSL defining vec3 linePosition(vec3), applied to both
+// ends before projection, so a vertex shader displacement can be reused;
+// begin() returns the program for its uniforms. Without instancing the
+// segments are expanded to four vertices each on the cpu, same shader.
+class DKLineRenderer
+{
+public:
+    DKLineRenderer();
+    
+    void setup();
+    void setup(string);
+    
+    DKLineSegment * map(int);
+    void unmap(int);
+    void write(const vector<DKLineSegment> &);
+    // kept on the gpu until replaced
+    void setSegments(const vector<DKLineSegment> &);
+    
+    ofShader & begin(float);
+    ofShader & begin(float, ofFbo &);
+    void draw();
+    void end();
+    void draw(float);
+    
+    int getNumSegments();
+    
+private:
+    void reserveCorners(int);
+    void expand(const DKLineSegment *, int, DKLineSegment *);
+    void attach(ofBufferObject &, size_t);
+    ofShader & use(ofShader &, float);
+    
+    DKShaderVariants shader;
+    ofShader * program;
+    bool instancing;
+    
+    ofVbo quad;
+    DKStreamBuffer stream;
+    ofBufferObject staticSegments;
+    bool staticMode;
+    int numSegments;
+    
+    // fallback only: segments as written, before expansion
+    vector<DKLineSegment> staging;
+    int numCorners;
+};
+
+#endif /* DKLineRenderer_hpp */
@@ -34,7 +34,7 @@ void DKMediaPool::init()
     
     float amp = pixelDensity >= 2 ? pixelDensity - 0.5 : 1.0;
     
-    font.load("ofxbraitsch/fonts/HelveticaNeueLTStd-Md.otf", 15, true, true);
+    labels.setFont(DKFontCache::get("ofxbraitsch/fonts/HelveticaNeueLTStd-Md.otf", 15, true, true));
     setModuleHasChild(true);
     alpha = 255;
     yOffsetGui = 22;
@@ -48,10 +48,11 @@ void DKMediaPool::init()
     modules = nullptr;
 	light = nullptr;
     
-    mainFbo.allocate(getModuleWidth(), getModuleHeight(), GL_RGBA, 4);
+    mainFbo.allocate(getModuleWidth(), getModuleHeight(), GL_RGBA);
     mainFbo.begin();
     ofClear(0, 0, 0,0);
     mainFbo.end();
+    if (usesRenderFbo()) allocateCanvasFbo(renderFbo);
     
     mediaPoolFbo.allocate(gui->getWidth(), gui->getWidth() * 0.5615);
     mediaPoolFbo.begin();
@@ -61,7 +62,7 @@ void DKMediaPool::init()
 
 	if (collection.size() > 0)
 	{
-		currentCanvas = collection[index].canvas;
+		currentCanvas = getCanvas(index);
 		currentCanvas->moduleIsChild = true;
 		addCustomParameters();
 		triggerPoolMedia(index);
@@ -74,7 +75,7 @@ void DKMediaPool::init()
     //MIDI mappings
     //to trigger the index 0 (first media) with midi cannel 16 pitch 0
     //use this:
-    //midiMappings.insert({"16/0", 0});
+    //midiMappings.insert({DKMidiDispatch::pack(MIDI_NOTE_ON, 16, 0), 0});
 
     addInputConnection(DKConnectionType::DK_FBO);
     addOutputConnection(DKConnectionType::DK_FBO);
@@ -91,46 +92,300 @@ void DKMediaPool::onKeyboardEvent(ofKeyEventArgs & e)
 
 void DKMediaPool::update()
 {
+	if (thumbnails.update()) updateMediaPool = true;
+	if (renderScaleSetting != renderScale) setRenderScale(renderScaleSetting);
+	if (warmFramesSetting != warmFrames) setWarmFrames(warmFramesSetting);
+	if (crossfadeFramesSetting != crossfadeFrames) setCrossfadeFrames(crossfadeFramesSetting);
+	if (liveThumbnailBudgetSetting != liveThumbnailBudget) setLiveThumbnailBudget(liveThumbnailBudgetSetting);
+	if (memoryBudgetSetting * (size_t) 1024 * 1024 != memoryBudget) setMemoryBudget(memoryBudgetSetting);
+
+	// the settings folder grows the gui, the pool grid follows it
+	yOffsetGui = gui->getHeight();
+
 	if (currentCanvas != nullptr)
 	{
 		if (nextIndex != index) triggerPoolMedia(nextIndex);
+		collection[index].presets.morph(presetMorph);
 		currentCanvas->setModuleMidiMapMode(getModuleMidiMapMode());
 		currentCanvas->gui->setPosition(gui->getPosition().x, gui->getPosition().y + gui->getWidth() * 0.5625 + yOffsetGui);
 		currentCanvas->gui->setTranslation(translation->x, translation->y, *zoom);
 
+		if (fadeFrame == 0 && deferredStandby >= 0)
+		{
+			int deferred = deferredStandby;
+			deferredStandby = -1;
+			prepareStandby(deferred);
+		}
+
 		if (light != nullptr)
 		{
-			ofEnableDepthTest();
-			ofEnableSmoothing();
-			ofEnableLighting();
+			DKGLState::setDepthTest(true);
+			DKGLState::setSmoothing(true);
+			DKGLState::setLighting(true);
 			light->enable();
 		}
 
-		mainFbo.begin();
+		// resolving into mainFbo is skipped while no wire reads it
+		bool consumed = outputConsumed;
+		outputConsumed = false;
+		outputStale = false;
+
+		if (fadeFrame > 0 && outgoingCanvas != nullptr)
+		{
+			// the outgoing canvas is disabled already, keep it running until the fade ends
+			outgoingCanvas->update();
+			renderCanvas(outgoingCanvas, fadeFbo);
+			renderCanvas(currentCanvas, standbyFbo);
 
-		ofPushStyle();
-		currentCanvas->draw();
-		ofPopStyle();
+			outputFade = 1.0 - (float) fadeFrame / (crossfadeFrames + 1);
+			if (consumed) composeFade(outputFade);
+			else outputStale = true;
 
-		if (hasInput)
+			fadeFrame--;
+			if (fadeFrame == 0) outgoingCanvas = nullptr;
+		}
+		else if (usesRenderFbo())
+		{
+			renderCanvas(currentCanvas, renderFbo);
+			outputFade = -1;
+			if (consumed) resolve(renderFbo);
+			else outputStale = true;
+		}
+		else
 		{
-			ofEnableBlendMode(OF_BLENDMODE_ADD);
-			inputFbo->draw(0, 0);
-			ofDisableBlendMode();
+			renderCanvas(currentCanvas, mainFbo);
+			DKTexture::touch(mainFbo);
 		}
 
-		mainFbo.end();
+		updateStandby();
+		updateLiveThumbnails();
+		prefetchNeighbours();
 
 		if (light != nullptr)
 		{
 			light->disable();
-			ofDisableLighting();
-			ofDisableSmoothing();
-			ofDisableDepthTest();
+			DKGLState::setLighting(false);
+			DKGLState::setSmoothing(false);
+			DKGLState::setDepthTest(false);
+		}
+	}
+}
+
+void DKMediaPool::renderCanvas(DKModule * canvas, ofFbo & fbo)
+{
+	fbo.begin();
+
+	// canvases always draw in project coordinates, scaled render targets scale them
+	ofPushMatrix();
+	ofScale(fbo.getWidth() / getModuleWidth(), fbo.getHeight() / getModuleHeight());
+
+	ofPushStyle();
+	canvas->draw();
+	ofPopStyle();
+
+	if (hasInput)
+	{
+		ofEnableBlendMode(OF_BLENDMODE_ADD);
+		inputFbo->draw(0, 0);
+		ofDisableBlendMode();
+	}
+
+	ofPopMatrix();
+	fbo.end();
+}
+
+void DKMediaPool::resolve(ofFbo & fbo)
+{
+	// drawing the multisampled fbo resolves it once, scaled targets get filtered to output size
+	mainFbo.begin();
+	ofClear(0, 0, 0, 0);
+	ofPushStyle();
+	ofSetColor(255);
+	fbo.draw(0, 0, mainFbo.getWidth(), mainFbo.getHeight());
+	ofPopStyle();
+	mainFbo.end();
+	DKTexture::touch(mainFbo);
+	outputStale = false;
+}
+
+void DKMediaPool::composeFade(float fade)
+{
+	// outgoing canvas in fadeFbo, incoming one in standbyFbo fading in over it
+	mainFbo.begin();
+	ofClear(0, 0, 0, 0);
+	ofPushStyle();
+	ofEnableAlphaBlending();
+	ofSetColor(255);
+	fadeFbo.draw(0, 0, mainFbo.getWidth(), mainFbo.getHeight());
+	ofSetColor(255, 255 * fade);
+	standbyFbo.draw(0, 0, mainFbo.getWidth(), mainFbo.getHeight());
+	ofPopStyle();
+	mainFbo.end();
+	DKTexture::touch(mainFbo);
+	outputStale = false;
+}
+
+bool DKMediaPool::usesRenderFbo()
+{
+	return samples > 1 || renderScale != 1.0;
+}
+
+void DKMediaPool::updateStandby()
+{
+	if (standbyIndex < 0 || standbyIndex == index || standbyFrames >= warmFrames) return;
+
+	DKModule * canvas = collection[standbyIndex].canvas;
+	canvas->update();
+	renderCanvas(canvas, standbyFbo);
+	standbyFrames++;
+}
+
+void DKMediaPool::updateLiveThumbnails()
+{
+	if (!liveThumbnails) return;
+
+	float millis;
+	while (liveThumbnailTimer.pollResult(millis)) liveThumbnailGpuCost = liveThumbnailGpuCost * 0.9 + millis * 0.1;
+
+	// unused budget carries over a little so slow canvases still get a turn
+	float cost = MAX(MAX(liveThumbnailGpuCost, liveThumbnailCpuCost), 0.01f);
+	liveThumbnailCredit = MIN(liveThumbnailCredit + liveThumbnailBudget, liveThumbnailBudget * 4);
+	if (liveThumbnailCredit < cost) return;
+
+	if (!liveThumbnailFbo.isAllocated())
+	{
+		liveThumbnailFbo.allocate(thumbnails.getCellWidth(), thumbnails.getCellHeight(), GL_RGBA);
+	}
+
+	for (int k = 0; k < 16 && liveThumbnailCredit >= cost; k++)
+	{
+		int cell = (liveThumbnailCursor + k) % 16;
+		int ind = page * 16 + cell;
+		if (ind >= collection.size() || ind == index || ind == standbyIndex) continue;
+
+		// only canvases that are already built, live thumbnails never instantiate
+		DKModule * canvas = collection[ind].canvas;
+		if (canvas == nullptr || canvas == currentCanvas || canvas == outgoingCanvas) continue;
+
+		uint64_t start = ofGetElapsedTimeMicros();
+		liveThumbnailTimer.begin();
+		canvas->update();
+		renderCanvas(canvas, liveThumbnailFbo);
+		thumbnails.copyToCell(collection[ind].thumbnail, liveThumbnailFbo);
+		liveThumbnailTimer.end();
+
+		float cpu = (ofGetElapsedTimeMicros() - start) / 1000.0;
+		liveThumbnailCpuCost = liveThumbnailCpuCost * 0.9 + cpu * 0.1;
+		liveThumbnailCredit -= cost;
+		liveThumbnailCursor = cell + 1;
+		updateMediaPool = true;
+	}
+}
+
+void DKMediaPool::prepareStandby(int ind)
+{
+	if (ind < 0 || ind >= collection.size() || ind == index || ind == standbyIndex) return;
+
+	// standbyFbo holds the incoming canvas of a crossfade and the outgoing
+	// canvas is still drawn, warm up once the fade is over
+	if (fadeFrame > 0)
+	{
+		deferredStandby = ind;
+		return;
+	}
+
+	allocateCanvasFbo(standbyFbo);
+	standbyIndex = ind;
+	standbyFrames = 0;
+	getCanvas(ind)->reset();
+}
+
+DKModule * DKMediaPool::getCanvas(int ind)
+{
+	CollectionItem & item = collection[ind];
+	item.lastUsed = ofGetFrameNum();
+	if (item.canvas == nullptr)
+	{
+		item.canvas = item.factory();
+		item.canvas->setupModule(item.name, { getModuleWidth(), getModuleHeight() }, true);
+		item.canvas->gui->setVisible(false);
+		item.canvas->moduleIsChild = true;
+		item.canvas->disable();
+		ofNotifyEvent(addModule, item.canvas, this);
+		enforceMemoryBudget(ind);
+	}
+	return item.canvas;
+}
+
+int DKMediaPool::getNumResident()
+{
+	int resident = 0;
+	for (auto & item : collection)
+		if (item.canvas != nullptr) resident++;
+	return resident;
+}
+
+size_t DKMediaPool::getCanvasFootprint()
+{
+	// rough estimate: a canvas keeps a few full resolution RGBA buffers around
+	return (size_t) getModuleWidth() * getModuleHeight() * 4 * 4;
+}
+
+void DKMediaPool::enforceMemoryBudget(int keep)
+{
+	size_t footprint = getCanvasFootprint();
+	while (getNumResident() * footprint > memoryBudget)
+	{
+		// least recently used canvas that can be built again
+		int oldest = -1;
+		for (int i = 0; i < collection.size(); i++)
+		{
+			CollectionItem & item = collection[i];
+			if (item.canvas == nullptr || !item.factory) continue;
+			if (i == keep || i == index || i == standbyIndex) continue;
+			if (item.canvas == currentCanvas || item.canvas == outgoingCanvas) continue;
+			if (oldest < 0 || item.lastUsed < collection[oldest].lastUsed) oldest = i;
 		}
+		if (oldest < 0) break;
+		evictCanvas(oldest);
 	}
 }
 
+void DKMediaPool::evictCanvas(int ind)
+{
+	DKModule * canvas = collection[ind].canvas;
+	collection[ind].canvas = nullptr;
+	collection[ind].presets.detach();
+	canvas->disable();
+	ofNotifyEvent(deleteModule, canvas, this);
+}
+
+void DKMediaPool::prefetchNeighbours()
+{
+	// at most one new canvas per frame, and only while it fits in the budget
+	if ((getNumResident() + 1) * getCanvasFootprint() > memoryBudget) return;
+
+	for (int ind : { index + 1, index - 1 })
+	{
+		if (ind < 0 || ind >= collection.size()) continue;
+		if (collection[ind].canvas != nullptr || !collection[ind].factory) continue;
+		getCanvas(ind);
+		return;
+	}
+}
+
+void DKMediaPool::allocateCanvasFbo(ofFbo & fbo)
+{
+	int w = getModuleWidth() * renderScale;
+	int h = getModuleHeight() * renderScale;
+	if (fbo.isAllocated() && fbo.getWidth() == w && fbo.getHeight() == h) return;
+
+	fbo.allocate(w, h, GL_RGBA, samples > 1 ? samples : 0);
+	fbo.begin();
+	ofClear(0, 0, 0, 0);
+	fbo.end();
+}
+
 void DKMediaPool::draw()
 {
     ofPoint pos = gui->getPosition();
@@ -148,6 +403,17 @@ void DKMediaPool::draw()
 }
 
 
+static void addQuad(ofMesh & mesh, ofRectangle rect, ofColor color)
+{
+    ofIndexType i = mesh.getNumVertices();
+    mesh.addVertex({ rect.getLeft(), rect.getTop(), 0 });
+    mesh.addVertex({ rect.getRight(), rect.getTop(), 0 });
+    mesh.addVertex({ rect.getRight(), rect.getBottom(), 0 });
+    mesh.addVertex({ rect.getLeft(), rect.getBottom(), 0 });
+    for (int k = 0; k < 4; k++) mesh.addColor(color);
+    mesh.addIndices({ i, i + 1, i + 2, i, i + 2, i + 3 });
+}
+
 void DKMediaPool::drawMediaPool()
 {
     mediaPoolFbo.begin();
@@ -158,77 +424,119 @@ void DKMediaPool::drawMediaPool()
     float cellWidth = width/4;
     float cellHeight = cellWidth * 0.5615;
 
-    ofPushStyle();
-    ofSetColor(255, 180);
+    // cells and thumbnails go out as two meshes instead of 16 draws each
+    ofMesh cells;
+    ofMesh thumbs;
+    cells.setMode(OF_PRIMITIVE_TRIANGLES);
+    thumbs.setMode(OF_PRIMITIVE_TRIANGLES);
 
     for(int i = 0; i < 4; i++)
     {
         for (int j = 0; j < 4; j++)
         {
-            ofFill();
-            int curIndex = i + 4 * j;
-            ofSetColor(66,66,74);
-            ofDrawRectangle(i*cellWidth, j*cellHeight, cellWidth-2, cellHeight - 2);
-            if(curIndex < collection.size())
+            int curIndex = page * 16 + i + 4 * j;
+            ofRectangle cell(i*cellWidth, j*cellHeight, cellWidth-2, cellHeight-2);
+            if(curIndex < collection.size() && thumbnails.isLoaded(collection[curIndex].thumbnail))
             {
-                ofSetColor(255);
-                collection[curIndex].thumbnail->draw(i*cellWidth,  j*cellHeight, cellWidth-2, cellHeight-2);
+                thumbnails.addCellToMesh(thumbs, collection[curIndex].thumbnail, cell);
             }
-            if(index == curIndex)
+            else
             {
-                ofSetColor(232, 181, 54, 255);
-                ofSetLineWidth(1);
-                ofNoFill();
-                ofDrawRectangle(i*cellWidth + 1, j*cellHeight + 1, cellWidth - 4, cellHeight - 4);
+                addQuad(cells, cell, ofColor(66,66,74));
             }
             if(getModuleMidiMapMode())
             {
-                ofFill();
-                ofSetColor(0, 200);
-                ofDrawRectangle(i*cellWidth, j*cellHeight, cellWidth - 2, cellHeight - 2);
-                
-                for (pair<string, int> element : midiMappings) {
-                    if(element.second == curIndex)
-                    {
-                        ofSetColor(255);
-                        font.drawString(element.first, i*cellWidth+2 + cellWidth/2 - 15, j*cellHeight + cellHeight/2 + 5);
-                    }
-                }
-                
+                addQuad(cells, cell, ofColor(0, 200));
                 if(index == curIndex)
                 {
-                    ofSetColor(255, 128);
-                    ofDrawRectangle(i*cellWidth, j*cellHeight, cellWidth - 4, cellHeight - 2);
+                    addQuad(cells, ofRectangle(i*cellWidth, j*cellHeight, cellWidth - 4, cellHeight - 2), ofColor(255, 128));
                 }
             }
         }
     }
+
+    ofPushStyle();
+    ofFill();
+    ofSetColor(255);
+    if(thumbs.getNumVertices() > 0)
+    {
+        thumbnails.getTexture().bind();
+        thumbs.draw();
+        thumbnails.getTexture().unbind();
+    }
+    cells.draw();
+
+    int selected = index - page * 16;
+    if(selected >= 0 && selected < 16)
+    {
+        ofSetColor(232, 181, 54, 255);
+        ofSetLineWidth(1);
+        ofNoFill();
+        ofDrawRectangle((selected % 4)*cellWidth + 1, (selected / 4)*cellHeight + 1, cellWidth - 4, cellHeight - 4);
+    }
+
+    if(getNumPages() > 1)
+    {
+        float pageWidth = (float) mediaPoolFbo.getWidth() / getNumPages();
+        ofFill();
+        ofSetColor(232, 181, 54, 255);
+        ofDrawRectangle(page * pageWidth, mediaPoolFbo.getHeight() - 2, pageWidth, 2);
+    }
+
+    if(getModuleMidiMapMode())
+    {
+        // every label of the page goes out in one draw
+        labels.clear();
+        for (pair<int, int> element : midiMappings)
+        {
+            int cell = element.second - page * 16;
+            int i = cell % 4;
+            int j = cell / 4;
+            if(cell >= 0 && cell < 16) labels.add(DKMidiDispatch::getLabel(element.first), i*cellWidth+2 + cellWidth/2 - 15, j*cellHeight + cellHeight/2 + 5, ofColor(255));
+        }
+        ofSetColor(255);
+        labels.draw();
+    }
     ofPopStyle();
     mediaPoolFbo.end();
 }
 
 
-void DKMediaPool::updatePoolIndex(int mouseX, int mouseY)
+bool DKMediaPool::isOverPool(float mouseX, float mouseY)
 {
     ofPoint pos = gui->getPosition();
     float offset = yOffsetGui + gui->getWidth() * 0.5625;
     
-    if (mouseX >= pos.x &&
-        mouseX <= pos.x + gui->getWidth() &&
+    return mouseX >= pos.x &&
+        mouseX < pos.x + gui->getWidth() &&
         mouseY >= pos.y + yOffsetGui &&
-        mouseY <= pos.y + offset) {
+        mouseY < pos.y + offset;
+}
+
+int DKMediaPool::getIndexAt(float mouseX, float mouseY)
+{
+    ofPoint pos = gui->getPosition();
+    float offset = yOffsetGui + gui->getWidth() * 0.5625;
+    
+    if (isOverPool(mouseX, mouseY)) {
         
         int xIndex = (int)  ofMap(mouseX, pos.x, pos.x + gui->getWidth(), 0,4);
         int yIndex = (int)  ofMap(mouseY, pos.y + yOffsetGui, pos.y + offset, 0 ,4);
         
-        int newIndex = 4 * yIndex + xIndex;
-        
-        if(newIndex <= collection.size())
-        {
-            index = newIndex;
-            drawMediaPool();
-            triggerPoolMedia(index);
-        }
+        int newIndex = page * 16 + 4 * yIndex + xIndex;
+        if(newIndex < collection.size()) return newIndex;
+    }
+    return -1;
+}
+
+void DKMediaPool::updatePoolIndex(int mouseX, int mouseY)
+{
+    int newIndex = getIndexAt(mouseX, mouseY);
+    if(newIndex >= 0)
+    {
+        index = newIndex;
+        drawMediaPool();
+        triggerPoolMedia(index);
     }
 }
 
@@ -236,22 +544,50 @@ void DKMediaPool::triggerPoolMedia(int ind)
 {
     if(ind < collection.size())
     {
+        // a warmed standby canvas was reset before its warm-up frames, don't reset it again
+        bool warm = ind == standbyIndex && standbyFrames > 0;
+        DKModule * previousCanvas = currentCanvas;
+        DKModule * canvas = getCanvas(ind);
+        
         currentCanvas->disable();
-        collection[ind].canvas->gui->setPosition(gui->getPosition().x - 400, gui->getPosition().y + 450 );
-        currentCanvas = collection[ind].canvas;
+        canvas->gui->setPosition(gui->getPosition().x - 400, gui->getPosition().y + 450 );
+        currentCanvas = canvas;
         string moduleName = getName() + "/" + currentCanvas->getName();
         currentCanvas->moduleIsChild = true;
         currentCanvas->enable();
-        currentCanvas->reset();
+        if(!warm) currentCanvas->reset();
         
         if(nextIndex != index) currentCanvas->triggerMidiEvent();
         nextIndex = index = ind;
         addCustomParameters();
         
-        mainFbo.begin();
-        ofClear(0,0,0,0);
-        mainFbo.end();
+        if(crossfadeFrames > 0 && previousCanvas != currentCanvas && mainFbo.isAllocated())
+        {
+            allocateCanvasFbo(fadeFbo);
+            allocateCanvasFbo(standbyFbo);
+            if(!warm)
+            {
+                standbyFbo.begin();
+                ofClear(0,0,0,0);
+                standbyFbo.end();
+            }
+            outgoingCanvas = previousCanvas;
+            fadeFrame = crossfadeFrames;
+        }
+        else if(warm)
+        {
+            // first frame of the cut is the last warm-up frame, no black flash
+            resolve(standbyFbo);
+        }
+        else
+        {
+            mainFbo.begin();
+            ofClear(0,0,0,0);
+            mainFbo.end();
+        }
         
+        standbyIndex = -1;
+        if(ind / 16 != page) setPage(ind / 16);
         updateMediaPool = true;
     }
 }
@@ -259,7 +595,36 @@ void DKMediaPool::triggerPoolMedia(int ind)
 
 void DKMediaPool::addModuleParameters()
 {
+	renderScaleSetting = renderScale;
+	warmFramesSetting = warmFrames;
+	crossfadeFramesSetting = crossfadeFrames;
+	liveThumbnailBudgetSetting = liveThumbnailBudget;
+	memoryBudgetSetting = memoryBudget / (1024 * 1024);
+
+	// the pool grid is drawn right below these, see yOffsetGui
+	ofxDatGuiFolder * settings = gui->addFolder("POOL SETTINGS");
+	ofxDatGuiMatrix * matrix = settings->addMatrix("samples", 4, false);
+	matrix->onMatrixEvent(this, &DKMediaPool::onSamplesChange);
+	matrix->setRadioMode(true);
+	matrix->getChildAt(2)->setSelected(true);
+	settings->addSlider("render scale", 0.25, 2.0, renderScale)->bind(renderScaleSetting);
+	settings->addSlider("warm frames", 0, 30, warmFrames)->bind(warmFramesSetting);
+	settings->addSlider("crossfade frames", 0, 120, crossfadeFrames)->bind(crossfadeFramesSetting);
+	settings->addToggle("live thumbnails", liveThumbnails)->onToggleEvent(this, &DKMediaPool::onLiveThumbnailsToggle);
+	settings->addSlider("thumbnail budget", 0, 8, liveThumbnailBudget)->setPrecision(2)->bind(liveThumbnailBudgetSetting);
+	// megabytes of resident canvases before the least recently used are evicted
+	settings->addSlider("memory budget", 128, 8192, memoryBudgetSetting)->bind(memoryBudgetSetting);
+}
+
+void DKMediaPool::onSamplesChange(ofxDatGuiMatrixEvent e)
+{
+	// buttons are 1, 2, 4 and 8 samples
+	setSamples(1 << e.child);
+}
 
+void DKMediaPool::onLiveThumbnailsToggle(ofxDatGuiToggleEvent e)
+{
+	setLiveThumbnails(e.target->getChecked());
 }
 
 void DKMediaPool::onMatrix1Change(ofxDatGuiMatrixEvent e)
@@ -277,16 +642,25 @@ void DKMediaPool::addCustomParameters()
     if(!currentCanvas->customParams)
     {
         currentCanvas->customParams = true;
+        currentCanvas->gui->addSlider("preset morph", 0, 1, 0)->bind(presetMorph);
+        currentCanvas->gui->addButton("save preset")->onButtonEvent(this, &DKMediaPool::onSavePresetButton);
     }
-    
+    collection[index].presets.attach(currentCanvas->gui, "preset morph");
+}
+
+void DKMediaPool::onSavePresetButton(ofxDatGuiButtonEvent e)
+{
+    savePreset();
 }
 
 void DKMediaPool::addItem(DKModule * module, string fileName, string name)
 {
-    vector<Preset> modulePresets;
-    
-    CollectionItem item = { name, module, fileName, new ofImage, modulePresets };
-    item.thumbnail->load(item.fileName);
+    CollectionItem item;
+    item.name = name;
+    item.canvas = module;
+    item.fileName = fileName;
+    item.thumbnail = thumbnails.add(fileName);
+    item.lastUsed = ofGetFrameNum();
     item.canvas->setupModule(name, {getModuleWidth(), getModuleHeight()}, true);
     item.canvas->gui->setVisible(false);
     item.canvas->moduleIsChild = true;
@@ -301,37 +675,46 @@ void DKMediaPool::addItem(DKModule * module, string fileName, string name)
 }
 
 
-void DKMediaPool::gotMidiMapping(string mapping)
+void DKMediaPool::addItem(std::function<DKModule*()> factory, string fileName, string name)
+{
+    CollectionItem item;
+    item.name = name;
+    item.canvas = nullptr;
+    item.fileName = fileName;
+    item.thumbnail = thumbnails.add(fileName);
+    item.factory = factory;
+    item.lastUsed = 0;
+    collection.push_back(item);
+	if (collection.size() == 1)
+	{
+		index = 0;
+		currentCanvas = getCanvas(0);
+		triggerPoolMedia(0);
+	}
+    numItems++;
+}
+
+bool DKMediaPool::learnMidiMapping(int key)
 {
-    
-    unordered_map<string, int>::iterator it;
-    it = midiMappings.find(mapping);
-    
     //midi mapping not found -> insert it
-    if(it == midiMappings.end())
+    if(this->getModuleMidiMapMode() && index >= 0 && midiMappings.count(key) == 0)
     {
-        if(this->getModuleMidiMapMode())
-        {
-            if(index >= 0)
-            {
-                midiMappings.insert({mapping, index});
-                updateMediaPool = true;
-            }
-        }
+        midiMappings.insert({key, index});
+        updateMediaPool = true;
+        return true;
     }
-    //midi mapping found -> do something
-    else {
-        if(!this->getModuleMidiMapMode())
-        {
-            int ind = midiMappings[mapping];
+    return false;
+}
+
+void DKMediaPool::triggerMidiMapping(int ind)
+{
+    if(this->getModuleMidiMapMode()) return;
     
-            if(ind != index)
-            {
-                nextIndex = ind;
-            } else {
-                currentCanvas->triggerMidiEvent();
-            }
-        }
+    if(ind != index)
+    {
+        nextIndex = ind;
+    } else {
+        currentCanvas->triggerMidiEvent();
     }
 }
 
@@ -348,6 +731,12 @@ void DKMediaPool::setCollectionName(string name)
 
 ofFbo * DKMediaPool::getFbo()
 {
+    // readers without a wire don't set outputConsumed
+    if (outputStale)
+    {
+        if (outputFade >= 0) composeFade(outputFade);
+        else resolve(renderFbo);
+    }
     return &mainFbo;
 }
 
@@ -371,6 +760,102 @@ void DKMediaPool::mousePressed(ofMouseEventArgs & mouse)
 	updatePoolIndex((mouse.x - translation->x) / (*zoom), (mouse.y - translation->y) / (*zoom));
 }
 
+void DKMediaPool::mouseMoved(ofMouseEventArgs & mouse)
+{
+	if (translation == nullptr) return;
+	int hoverIndex = getIndexAt((mouse.x - translation->x) / (*zoom), (mouse.y - translation->y) / (*zoom));
+	if (hoverIndex >= 0) prepareStandby(hoverIndex);
+}
+
+void DKMediaPool::mouseScrolled(ofMouseEventArgs & mouse)
+{
+	if (translation == nullptr || mouse.scrollY == 0) return;
+	if (!isOverPool((mouse.x - translation->x) / (*zoom), (mouse.y - translation->y) / (*zoom))) return;
+	setPage(page + (mouse.scrollY > 0 ? -1 : 1));
+}
+
+void DKMediaPool::setPage(int p)
+{
+	page = ofClamp(p, 0, getNumPages() - 1);
+	thumbnails.setResident(page * 16, 16);
+	updateMediaPool = true;
+}
+
+int DKMediaPool::getPage()
+{
+	return page;
+}
+
+int DKMediaPool::getNumPages()
+{
+	return MAX(1, ((int) collection.size() + 15) / 16);
+}
+
+void DKMediaPool::setMemoryBudget(size_t megabytes)
+{
+	memoryBudget = megabytes * 1024 * 1024;
+	enforceMemoryBudget(index);
+}
+
+void DKMediaPool::setSamples(int s)
+{
+	// 1, 2, 4 or 8 samples, capped by what the driver supports
+	int supported = MAX(ofFbo::maxSamples(), 1);
+	samples = 1;
+	while (samples * 2 <= MIN(s, 8) && samples * 2 <= supported) samples *= 2;
+
+	reallocateCanvasFbos();
+}
+
+void DKMediaPool::setRenderScale(float scale)
+{
+	// below 1 renders subsampled, above 1 supersampled
+	renderScale = ofClamp(scale, 0.25, 2.0);
+
+	reallocateCanvasFbos();
+}
+
+void DKMediaPool::reallocateCanvasFbos()
+{
+	bool standby = standbyFbo.isAllocated();
+	bool fade = fadeFbo.isAllocated();
+	renderFbo.clear();
+	standbyFbo.clear();
+	fadeFbo.clear();
+
+	// warm-up and fades restart from scratch with the new targets
+	standbyIndex = -1;
+	deferredStandby = -1;
+	fadeFrame = 0;
+	outgoingCanvas = nullptr;
+	outputStale = false;
+
+	if (usesRenderFbo()) allocateCanvasFbo(renderFbo);
+	if (standby) allocateCanvasFbo(standbyFbo);
+	if (fade) allocateCanvasFbo(fadeFbo);
+}
+
+void DKMediaPool::setLiveThumbnails(bool live)
+{
+	liveThumbnails = live;
+	liveThumbnailCredit = 0;
+}
+
+void DKMediaPool::setLiveThumbnailBudget(float millis)
+{
+	liveThumbnailBudget = MAX(millis, 0.0f);
+}
+
+void DKMediaPool::setWarmFrames(int frames)
+{
+	warmFrames = MAX(frames, 0);
+}
+
+void DKMediaPool::setCrossfadeFrames(int frames)
+{
+	crossfadeFrames = MAX(frames, 0);
+}
+
 void DKMediaPool::unMount()
 {
 	if (currentCanvas != nullptr)
@@ -398,11 +883,8 @@ void DKMediaPool::setTranslationReferences(ofVec2f* t, float* z)
 
 void DKMediaPool::savePreset()
 {
-    /*unordered_map<string, float> preset;
-    for(ofxDatGuiComponent * param : currentCanvas->params->children)
-    {
-        preset.insert({param->getName(), param->getComponentScale()});
-    }
-    string name = "preset-"+ofToString(collection[index].presets.size());
-    collection[index].presets.push_back({name, preset});*/
+    if(currentCanvas == nullptr) return;
+    
+    DKPresetBank & bank = collection[index].presets;
+    bank.save("preset-" + ofToString(bank.getNumPresets()));
 }
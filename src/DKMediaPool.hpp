@@ -24,23 +24,27 @@
 #define canvasCollection_hpp
 
 #include "DKModule.hpp"
+#include "DKThumbnailAtlas.hpp"
+#include "DKPresetBank.hpp"
+#include "DKMidiDispatch.hpp"
+#include "DKCueList.hpp"
+#include "DKFontCache.hpp"
+#include "DKGpuTimer.hpp"
 #include <math.h>
 
 #include "ofxMidi.h"
 
 
-struct Preset{
-    string name;
-    unordered_map<string, float> presetValues;
-};
-
 class CollectionItem{
 public:
     string name;
     DKModule * canvas;
     string fileName;
-    ofImage * thumbnail;
-    vector<Preset> presets;
+    int thumbnail;
+    DKPresetBank presets;
+    // lazy items are built on first use and can be torn down again
+    std::function<DKModule*()> factory;
+    uint64_t lastUsed;
 };
 
 
@@ -58,9 +62,50 @@ private:
     bool updateMediaPool = false;
     DKModule * currentCanvas;
 
+    // canvases draw into renderFbo when it is multisampled or scaled,
+    // mainFbo is the single sample output resolved from it
     ofFbo mainFbo;
+    ofFbo renderFbo;
     ofFbo mediaPoolFbo;
+    int samples = 4;
+    float renderScale = 1.0;
+    // mainFbo is only brought up to date while a wire reads it, getFbo()
+    // catches up with the resolve or crossfade skipped this frame
+    bool outputStale = false;
+    float outputFade = -1;
+    float renderScaleSetting = 1.0;
     ofFbo *inputFbo;
+    DKThumbnailAtlas thumbnails;
+    
+    // live thumbnails: inactive canvases of the page redraw their cell while
+    // the measured cost fits in a per-frame budget of milliseconds
+    ofFbo liveThumbnailFbo;
+    DKGpuTimer liveThumbnailTimer;
+    bool liveThumbnails = false;
+    float liveThumbnailBudget = 1.0;
+    float liveThumbnailBudgetSetting = 1.0;
+    float liveThumbnailCredit = 0;
+    float liveThumbnailGpuCost = 1.0;
+    float liveThumbnailCpuCost = 1.0;
+    int liveThumbnailCursor = 0;
+    
+    // warm standby: the predicted next canvas runs off-screen for a few
+    // frames so the cut doesn't pay for lazy allocations and shader compiles
+    ofFbo standbyFbo;
+    ofFbo fadeFbo;
+    int standbyIndex = -1;
+    int deferredStandby = -1;
+    int page = 0;
+    float presetMorph = 0;
+    size_t memoryBudget = (size_t) 1024 * 1024 * 1024;
+    int memoryBudgetSetting = 1024;
+    int standbyFrames = 0;
+    int warmFrames = 3;
+    int crossfadeFrames = 0;
+    int warmFramesSetting = 3;
+    int crossfadeFramesSetting = 0;
+    int fadeFrame = 0;
+    DKModule * outgoingCanvas = nullptr;
 
 	ofLight* light;
     
@@ -69,20 +114,37 @@ private:
     ofVec2f * translation;
 	float* zoom;
     
-    ofEvent<string> deleteModule;
-    ofEvent<DKModule*> addModule;
 	unordered_map<string, DKModule*> * modules;
     int yOffsetGui;
-    ofTrueTypeFont	font;
+    DKTextBatch labels;
     
     float size;
     float time0;
     float time;
     
+    void allocateCanvasFbo(ofFbo &);
+    bool usesRenderFbo();
+    void reallocateCanvasFbos();
+    void resolve(ofFbo &);
+    void composeFade(float);
+    bool isOverPool(float, float);
+    void evictCanvas(int);
+    void enforceMemoryBudget(int);
+    void prefetchNeighbours();
+    size_t getCanvasFootprint();
+    void renderCanvas(DKModule *, ofFbo &);
+    void updateStandby();
+    void updateLiveThumbnails();
     
 public:
     vector<CollectionItem> collection;
-    unordered_map<string, int> midiMappings;
+    // packed midi key (see DKMidiDispatch::pack) -> collection index
+    unordered_map<int, int> midiMappings;
+    
+    // lazily built canvases are announced here, the owner of the module map
+    // registers them and deletes them once they are evicted
+    ofEvent<DKModule*> deleteModule;
+    ofEvent<DKModule*> addModule;
     
     void init();
     void setup();
@@ -91,10 +153,16 @@ public:
     void addModuleParameters();
     void addCustomParameters();
     void addItem(DKModule *, string, string);
+    void addItem(std::function<DKModule*()>, string, string);
+    DKModule * getCanvas(int);
+    int getNumResident();
     void onMidiInputListChange(ofxDatGuiDropdownEvent);
     void onToggleDraw(ofxDatGuiToggleEvent);
+    void onSavePresetButton(ofxDatGuiButtonEvent);
     
     void onMatrix1Change(ofxDatGuiMatrixEvent);
+    void onSamplesChange(ofxDatGuiMatrixEvent);
+    void onLiveThumbnailsToggle(ofxDatGuiToggleEvent);
     void onKeyboardEvent(ofKeyEventArgs & e);
     
     DKModule * getChildModule();
@@ -103,7 +171,10 @@ public:
     void updatePoolIndex(int, int);
     //void onMouseMove(int, int);
     void triggerPoolMedia(int);
-    void gotMidiMapping(string);
+    void prepareStandby(int);
+    int getIndexAt(float, float);
+    bool learnMidiMapping(int);
+    void triggerMidiMapping(int);
     void gotMidiMessage(ofxMidiMessage*);
     void sendMidiNote(ofxMidiMessage*);
     
@@ -118,8 +189,20 @@ public:
     void setCollectionName(string);
     void setModulesReference(unordered_map<string, DKModule*> *);
     void setTranslationReferences(ofVec2f *, float*);
+    void setWarmFrames(int);
+    void setCrossfadeFrames(int);
+    void setMemoryBudget(size_t);
+    void setSamples(int);
+    void setLiveThumbnails(bool);
+    void setLiveThumbnailBudget(float);
+    void setRenderScale(float);
+    void setPage(int);
+    int getPage();
+    int getNumPages();
     
     void mousePressed(ofMouseEventArgs & mouse);
+    void mouseMoved(ofMouseEventArgs & mouse);
+    void mouseScrolled(ofMouseEventArgs & mouse);
     
     void savePreset();
 };
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKMidiDispatch.hpp"
+#include "DKMediaPool.hpp"
+#include "DKCueList.hpp"
+
+// 3 bits of status (0x8 - 0xF), 4 bits of channel, 7 bits of data1
+#define DK_MIDI_KEYS (1 << 14)
+
+DKMidiDispatch::DKMidiDispatch()
+{
+    first.assign(DK_MIDI_KEYS + 1, 0);
+}
+
+int DKMidiDispatch::pack(int status, int channel, int data1)
+{
+    return (((status >> 4) & 0x7) << 11) | (((channel - 1) & 0xF) << 7) | (data1 & 0x7F);
+}
+
+int DKMidiDispatch::pack(ofxMidiMessage & msg)
+{
+    int data1 = msg.status == MIDI_CONTROL_CHANGE ? msg.control : msg.pitch;
+    return pack(msg.status, msg.channel, data1);
+}
+
+string DKMidiDispatch::getLabel(int key)
+{
+    return ofToString(((key >> 7) & 0xF) + 1) + "/" + ofToString(key & 0x7F);
+}
+
+void DKMidiDispatch::clear()
+{
+    targets.clear();
+    pools.clear();
+    first.assign(DK_MIDI_KEYS + 1, 0);
+}
+
+void DKMidiDispatch::addSlider(int key, ofxDatGuiComponent * component)
+{
+    targets.push_back({ key, component, nullptr, nullptr, 0 });
+}
+
+void DKMidiDispatch::addPoolTrigger(int key, DKMediaPool * pool, int index)
+{
+    targets.push_back({ key, nullptr, pool, nullptr, index });
+}
+
+void DKMidiDispatch::addCueTrigger(int key, DKCueList * cues, int cue)
+{
+    targets.push_back({ key, nullptr, nullptr, cues, cue });
+}
+
+void DKMidiDispatch::addPool(DKMediaPool * pool)
+{
+    pools.push_back(pool);
+}
+
+void DKMidiDispatch::build()
+{
+    std::stable_sort(targets.begin(), targets.end(), [](const Target & a, const Target & b) { return a.key < b.key; });
+    
+    first.assign(DK_MIDI_KEYS + 1, 0);
+    for (auto & target : targets) first[target.key + 1]++;
+    for (int k = 0; k < DK_MIDI_KEYS; k++) first[k + 1] += first[k];
+}
+
+bool DKMidiDispatch::dispatch(ofxMidiMessage & msg)
+{
+    // a note on with velocity 0 is a note off, it never triggers anything
+    if (msg.status == MIDI_NOTE_ON && msg.velocity == 0) return false;
+    
+    int key = pack(msg);
+    if (first[key] == first[key + 1]) return false;
+    
+    for (uint32_t i = first[key]; i < first[key + 1]; i++)
+    {
+        Target & target = targets[i];
+        if (target.pool != nullptr)
+        {
+            target.pool->triggerMidiMapping(target.index);
+        }
+        else if (target.cues != nullptr)
+        {
+            target.cues->trigger(target.index);
+        }
+        else
+        {
+            static_cast<ofxDatGuiSlider*>(target.component)->setComponentScale(msg.value / 127.0);
+        }
+    }
+    return true;
+}
+
+vector<DKMediaPool*> & DKMidiDispatch::getPools()
+{
+    return pools;
+}
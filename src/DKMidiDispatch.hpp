@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKMidiDispatch_hpp
+#define DKMidiDispatch_hpp
+
+#include "ofMain.h"
+#include "ofxMidi.h"
+#include "ofxDatGui.h"
+
+class DKMediaPool;
+class DKCueList;
+
+// Every midi-learn binding compiled into one table indexed by a packed
+// (status, channel, data1) key. Dispatching a message is an array lookup
+// plus a walk over the targets bound to that key.
+class DKMidiDispatch
+{
+public:
+    DKMidiDispatch();
+    
+    static int pack(int, int, int);
+    static int pack(ofxMidiMessage &);
+    static string getLabel(int);
+    
+    void clear();
+    void addSlider(int, ofxDatGuiComponent *);
+    void addPoolTrigger(int, DKMediaPool *, int);
+    void addCueTrigger(int, DKCueList *, int);
+    void addPool(DKMediaPool *);
+    void build();
+    
+    bool dispatch(ofxMidiMessage &);
+    vector<DKMediaPool*> & getPools();
+    
+private:
+    struct Target
+    {
+        int key;
+        ofxDatGuiComponent * component;
+        DKMediaPool * pool;
+        DKCueList * cues;
+        int index;
+    };
+    
+    vector<Target> targets;
+    // targets of key k live in [first[k], first[k + 1])
+    vector<uint32_t> first;
+    vector<DKMediaPool*> pools;
+};
+
+#endif /* DKMidiDispatch_hpp */
@@ -133,25 +133,46 @@ void DKModule::drawModule()
 
 void DKModule::drawPlane()
 {
-    ofVboMesh quad;
-    quad.getVertices().resize(4);
-    quad.getTexCoords().resize(4);
-    quad.setMode(OF_PRIMITIVE_TRIANGLE_FAN);
-    
     int w = getModuleWidth();
     int h = getModuleHeight();
     
-    quad.setVertex(0, ofVec3f(0,0,0));
-    quad.setVertex(1, ofVec3f(w,0,0));
-    quad.setVertex(2, ofVec3f(w,h,0));
-    quad.setVertex(3, ofVec3f(0,h,0));
+    //the quad only gets rebuilt (and re-uploaded) when the resolution changes
+    if(planeMesh.getNumVertices() != 4 || planeMesh.getVertex(2) != glm::vec3(w,h,0))
+    {
+        planeMesh.clear();
+        planeMesh.getVertices().resize(4);
+        planeMesh.getTexCoords().resize(4);
+        planeMesh.setMode(OF_PRIMITIVE_TRIANGLE_FAN);
+        
+        planeMesh.setVertex(0, ofVec3f(0,0,0));
+        planeMesh.setVertex(1, ofVec3f(w,0,0));
+        planeMesh.setVertex(2, ofVec3f(w,h,0));
+        planeMesh.setVertex(3, ofVec3f(0,h,0));
+
+        planeMesh.setTexCoord(0, ofVec2f(0,0));
+        planeMesh.setTexCoord(1, ofVec2f(w,0));
+        planeMesh.setTexCoord(2, ofVec2f(w,h));
+        planeMesh.setTexCoord(3, ofVec2f(0,h));
+    }
 
-    quad.setTexCoord(0, ofVec2f(0,0));
-    quad.setTexCoord(1, ofVec2f(w,0));
-    quad.setTexCoord(2, ofVec2f(w,h));
-    quad.setTexCoord(3, ofVec2f(0,h));
+    planeMesh.draw();
+}
+
+bool DKModule::setMidiMapping(int key)
+{
+    //bind the slider selected in midi map mode to a packed midi key
+    if(!moduleMidiMapMode || selectedComponent == nullptr) return false;
+    midiMappings[key] = selectedComponent;
+    return true;
+}
 
-    quad.draw();
+void DKModule::deleteMapping()
+{
+    for(auto it = midiMappings.begin(); it != midiMappings.end(); )
+    {
+        if(it->second == selectedComponent) it = midiMappings.erase(it);
+        else it++;
+    }
 }
 
 void DKModule::toggleMidiMap()
@@ -184,6 +205,11 @@ bool DKModule::getModuleMidiMapMode()
     return moduleMidiMapMode;
 }
 
+const unordered_map<int, ofxDatGuiComponent *> & DKModule::getMidiMappings()
+{
+    return midiMappings;
+}
+
 ofxDatGuiComponent * DKModule::getOutputComponent(int x, int y)
 {
     return gui->getOutputComponent(x, y);
@@ -28,6 +28,14 @@
 #include "ofxMidi.h"
 #include "unordered_map"
 #include "DKWireConnection.hpp"
+#include "DKTexture.hpp"
+#include "DKReadback.hpp"
+#include "DKGLState.hpp"
+#include "DKThreadPool.hpp"
+#include "DKStreamBuffer.hpp"
+#include "DKLineRenderer.hpp"
+#include "DKNoise.hpp"
+#include "DKLfoEngine.hpp"
 #include "ofxPostProcessing.h"
 
 
@@ -56,19 +64,22 @@ private:
     float   moduleAlpha;
     float   moduleWidth;
     float   moduleHeight;
+    ofVboMesh planeMesh;
     
     float   moduleGuiOpacity;
 	ofPoint translation;
 	float	zoom;
     
     ofxDatGuiComponent * selectedComponent;
-    unordered_map<string, ofxDatGuiComponent *> midiMappings;
+    unordered_map<int, ofxDatGuiComponent *> midiMappings;
 public:
 	vector<ofxMidiMessage*> outMidiMessages;
     
 	float  moduleGuiWidth;
     bool customParams = false;
     bool moduleIsChild = false;
+    // set every frame by the active DK_FBO wires leaving this module
+    bool outputConsumed = false;
     ofxDatGui * gui;
 
     vector<DKWireConnection*> inputs;
@@ -76,6 +87,7 @@ public:
     vector<DKWireConnection*> chainOutputs;
     DKModule* chainModule;
     
+    virtual ~DKModule() { };
     virtual void setup() { };
     virtual void update() { };
     virtual void draw() { };
@@ -85,6 +97,7 @@ public:
     virtual void setFbo(ofFbo *){ };
     virtual void setFbo(ofFbo *, int) { };
 	virtual void setLight(ofLight*) { };
+    virtual void setTextureView(DKTextureView*) { };
     virtual void onMouseMove(int, int) { };
     virtual void triggerMidiEvent(){ };
     virtual void triggerMidiMessage(ofxMidiMessage *) { };
@@ -92,6 +105,7 @@ public:
     
     virtual ofFbo * getFbo(){ return nullptr; };
 	virtual ofLight* getLight() { return nullptr; };
+    virtual DKTextureView* getTextureView() { return nullptr; };
     virtual ofxPostProcessing* getChain() { return nullptr; };
     
 
@@ -133,8 +147,9 @@ public:
     DKWireConnection * getOutputConnection(float, float);
     DKWireConnection * getInputConnection(float, float);
     
-    void setMidiMapping(string);
-    void setMidiScale(string, double);
+    bool setMidiMapping(int);
+    // packed midi key (see DKMidiDispatch::pack) -> learned slider
+    const unordered_map<int, ofxDatGuiComponent *> & getMidiMappings();
     void setModuleMidiMapMode(bool);
     void setResolution(int, int);
     void toggleMidiMap();
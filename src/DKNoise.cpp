@@ -0,0 +1,761 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKNoise.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DK_NOISE_LANES 8
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DK_NOISE_LANES 4
+#endif
+
+// Perlin's permutation, repeated so a hash plus an offset never wraps
+static const int perm[512] = {
+    151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+    140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+    247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+    57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+    74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+    60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+    65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+    200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+    52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+    207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+    119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+    129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+    81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+    184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+    222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+    151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+    140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+    247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+    57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+    74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+    60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+    65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+    200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+    52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+    207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+    119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+    129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+    81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+    184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+    222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180
+};
+
+// 4d simplex traversal order, indexed by the 6 pairwise comparisons of the
+// cell offsets, 4 ranks per entry
+static const int simplexOrder[256] = {
+    0, 1, 2, 3, 0, 1, 3, 2, 0, 0, 0, 0, 0, 2, 3, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 0,
+    0, 2, 1, 3, 0, 0, 0, 0, 0, 3, 1, 2, 0, 3, 2, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 3, 2, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 2, 0, 3, 0, 0, 0, 0, 1, 3, 0, 2, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 2, 3, 0, 1, 2, 3, 1, 0,
+    1, 0, 2, 3, 1, 0, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 2, 0, 3, 1, 0, 0, 0, 0, 2, 1, 3, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    2, 0, 1, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 0, 1, 2, 3, 0, 2, 1, 0, 0, 0, 0, 3, 1, 2, 0,
+    2, 1, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 1, 0, 2, 0, 0, 0, 0, 3, 2, 0, 1, 3, 2, 1, 0
+};
+
+// Every kernel below is written once against a "lane" type: plain float/int
+// for the scalar path, F8/I8/M8 (8 floats, 8 ints, 8 lane mask) for AVX2 and
+// F4/I4/M4 for NEON. The helpers give all of them the same vocabulary.
+
+static inline int fastFloor(float x) { return x > 0 ? (int) x : (int) x - 1; }
+static inline int floorInt(float x) { return (int) floorf(x); }
+static inline float toFloat(int i) { return (float) i; }
+static inline int maskInt(bool m) { return m ? 1 : 0; }
+static inline float select(bool m, float a, float b) { return m ? a : b; }
+static inline bool test(int i, int bits) { return (i & bits) != 0; }
+static inline int gather(const int * table, int i) { return table[i]; }
+static inline float positive(float x) { return x < 0 ? 0 : x; }
+
+#if defined(__AVX2__)
+struct F8
+{
+    __m256 v;
+    F8() { }
+    F8(__m256 a) : v(a) { }
+    F8(float f) : v(_mm256_set1_ps(f)) { }
+};
+
+struct I8
+{
+    __m256i v;
+    I8() { }
+    I8(__m256i a) : v(a) { }
+    I8(int i) : v(_mm256_set1_epi32(i)) { }
+};
+
+struct M8
+{
+    __m256 v;
+    M8(__m256 a) : v(a) { }
+};
+
+static inline F8 operator+(F8 a, F8 b) { return _mm256_add_ps(a.v, b.v); }
+static inline F8 operator-(F8 a, F8 b) { return _mm256_sub_ps(a.v, b.v); }
+static inline F8 operator*(F8 a, F8 b) { return _mm256_mul_ps(a.v, b.v); }
+static inline F8 operator-(F8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+static inline F8 & operator+=(F8 & a, F8 b) { return a = a + b; }
+static inline F8 & operator*=(F8 & a, F8 b) { return a = a * b; }
+static inline I8 operator+(I8 a, I8 b) { return _mm256_add_epi32(a.v, b.v); }
+static inline I8 operator-(I8 a, I8 b) { return _mm256_sub_epi32(a.v, b.v); }
+static inline I8 operator*(I8 a, I8 b) { return _mm256_mullo_epi32(a.v, b.v); }
+static inline I8 operator&(I8 a, I8 b) { return _mm256_and_si256(a.v, b.v); }
+
+static inline M8 operator>(F8 a, F8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+static inline M8 operator>=(F8 a, F8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+static inline M8 operator<(I8 a, I8 b) { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b.v, a.v)); }
+static inline M8 operator>=(I8 a, I8 b) { return _mm256_xor_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b.v, a.v)), _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+static inline M8 operator==(I8 a, I8 b) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a.v, b.v)); }
+static inline M8 operator&&(M8 a, M8 b) { return _mm256_and_ps(a.v, b.v); }
+static inline M8 operator||(M8 a, M8 b) { return _mm256_or_ps(a.v, b.v); }
+static inline M8 operator!(M8 a) { return _mm256_xor_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+
+static inline I8 fastFloor(F8 x)
+{
+    I8 t = _mm256_cvttps_epi32(x.v);
+    return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps((t - 1).v), _mm256_castsi256_ps(t.v), (x > 0.0f).v));
+}
+static inline I8 floorInt(F8 x) { return _mm256_cvttps_epi32(_mm256_floor_ps(x.v)); }
+static inline F8 toFloat(I8 i) { return _mm256_cvtepi32_ps(i.v); }
+static inline I8 maskInt(M8 m) { return _mm256_and_si256(_mm256_castps_si256(m.v), _mm256_set1_epi32(1)); }
+static inline F8 select(M8 m, F8 a, F8 b) { return _mm256_blendv_ps(b.v, a.v, m.v); }
+static inline M8 test(I8 i, int bits) { return !(((i & bits) == 0)); }
+static inline I8 gather(const int * table, I8 i) { return _mm256_i32gather_epi32(table, i.v, 4); }
+static inline F8 positive(F8 x) { return _mm256_max_ps(x.v, _mm256_setzero_ps()); }
+static inline F8 load(const float * p) { return _mm256_loadu_ps(p); }
+static inline void store(float * p, F8 x) { _mm256_storeu_ps(p, x.v); }
+static inline F8 laneOffsets() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+typedef F8 Lanes;
+#elif defined(__ARM_NEON)
+struct F4
+{
+    float32x4_t v;
+    F4() { }
+    F4(float32x4_t a) : v(a) { }
+    F4(float f) : v(vdupq_n_f32(f)) { }
+};
+
+struct I4
+{
+    int32x4_t v;
+    I4() { }
+    I4(int32x4_t a) : v(a) { }
+    I4(int i) : v(vdupq_n_s32(i)) { }
+};
+
+struct M4
+{
+    uint32x4_t v;
+    M4(uint32x4_t a) : v(a) { }
+};
+
+static inline F4 operator+(F4 a, F4 b) { return vaddq_f32(a.v, b.v); }
+static inline F4 operator-(F4 a, F4 b) { return vsubq_f32(a.v, b.v); }
+static inline F4 operator*(F4 a, F4 b) { return vmulq_f32(a.v, b.v); }
+static inline F4 operator-(F4 a) { return vnegq_f32(a.v); }
+static inline F4 & operator+=(F4 & a, F4 b) { return a = a + b; }
+static inline F4 & operator*=(F4 & a, F4 b) { return a = a * b; }
+static inline I4 operator+(I4 a, I4 b) { return vaddq_s32(a.v, b.v); }
+static inline I4 operator-(I4 a, I4 b) { return vsubq_s32(a.v, b.v); }
+static inline I4 operator*(I4 a, I4 b) { return vmulq_s32(a.v, b.v); }
+static inline I4 operator&(I4 a, I4 b) { return vandq_s32(a.v, b.v); }
+
+static inline M4 operator>(F4 a, F4 b) { return vcgtq_f32(a.v, b.v); }
+static inline M4 operator>=(F4 a, F4 b) { return vcgeq_f32(a.v, b.v); }
+static inline M4 operator<(I4 a, I4 b) { return vcltq_s32(a.v, b.v); }
+static inline M4 operator>=(I4 a, I4 b) { return vcgeq_s32(a.v, b.v); }
+static inline M4 operator==(I4 a, I4 b) { return vceqq_s32(a.v, b.v); }
+static inline M4 operator&&(M4 a, M4 b) { return vandq_u32(a.v, b.v); }
+static inline M4 operator||(M4 a, M4 b) { return vorrq_u32(a.v, b.v); }
+static inline M4 operator!(M4 a) { return vmvnq_u32(a.v); }
+
+static inline I4 fastFloor(F4 x)
+{
+    I4 t = vcvtq_s32_f32(x.v);
+    return vbslq_s32((x > 0.0f).v, t.v, (t - 1).v);
+}
+// a truncated value above x is one too high, the all ones mask adds -1
+static inline I4 floorInt(F4 x)
+{
+    I4 t = vcvtq_s32_f32(x.v);
+    return t + I4(vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(t.v), x.v)));
+}
+static inline F4 toFloat(I4 i) { return vcvtq_f32_s32(i.v); }
+static inline I4 maskInt(M4 m) { return vandq_s32(vreinterpretq_s32_u32(m.v), vdupq_n_s32(1)); }
+static inline F4 select(M4 m, F4 a, F4 b) { return vbslq_f32(m.v, a.v, b.v); }
+static inline M4 test(I4 i, int bits) { return vtstq_s32(i.v, vdupq_n_s32(bits)); }
+// no gather instruction, the lanes are looked up one by one
+static inline I4 gather(const int * table, I4 i)
+{
+    int32_t index[4], value[4];
+    vst1q_s32(index, i.v);
+    for (int l = 0; l < 4; l++) value[l] = table[index[l]];
+    return vld1q_s32(value);
+}
+static inline F4 positive(F4 x) { return vmaxq_f32(x.v, vdupq_n_f32(0)); }
+static inline F4 load(const float * p) { return vld1q_f32(p); }
+static inline void store(float * p, F4 x) { vst1q_f32(p, x.v); }
+static inline F4 laneOffsets() { const float offsets[4] = { 0, 1, 2, 3 }; return vld1q_f32(offsets); }
+typedef F4 Lanes;
+#endif
+
+// gradients, same as ofNoise
+
+template<class F, class I> static inline F grad1(I hash, F x)
+{
+    I h = hash & 15;
+    F grad = 1.0f + toFloat(h & 7);
+    grad = select(test(h, 8), -grad, grad);
+    return grad * x;
+}
+
+template<class F, class I> static inline F grad2(I hash, F x, F y)
+{
+    I h = hash & 7;
+    F u = select(h < 4, x, y);
+    F v = select(h < 4, y, x);
+    return select(test(h, 1), -u, u) + select(test(h, 2), -2.0f * v, 2.0f * v);
+}
+
+template<class F, class I> static inline F grad3(I hash, F x, F y, F z)
+{
+    I h = hash & 15;
+    F u = select(h < 8, x, y);
+    F v = select(h < 4, y, select(h == 12 || h == 14, x, z));
+    return select(test(h, 1), -u, u) + select(test(h, 2), -v, v);
+}
+
+template<class F, class I> static inline F grad4(I hash, F x, F y, F z, F t)
+{
+    I h = hash & 31;
+    F u = select(h < 24, x, y);
+    F v = select(h < 16, y, z);
+    F w = select(h < 8, z, t);
+    return select(test(h, 1), -u, u) + select(test(h, 2), -v, v) + select(test(h, 4), -w, w);
+}
+
+template<class F> static inline F fade(F t)
+{
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+template<class F> static inline F lerp(F t, F a, F b)
+{
+    return a + t * (b - a);
+}
+
+// simplex, the ofNoise arithmetic
+
+template<class F> static inline F simplex1(F x)
+{
+    auto i0 = fastFloor(x);
+    auto i1 = i0 + 1;
+    F x0 = x - toFloat(i0);
+    F x1 = x0 - 1.0f;
+    
+    F t0 = 1.0f - x0 * x0;
+    t0 *= t0;
+    F n0 = t0 * t0 * grad1(gather(perm, i0 & 0xff), x0);
+    F t1 = 1.0f - x1 * x1;
+    t1 *= t1;
+    F n1 = t1 * t1 * grad1(gather(perm, i1 & 0xff), x1);
+    return 0.25f * (n0 + n1);
+}
+
+template<class F> static inline F simplex2(F x, F y)
+{
+    const float F2 = 0.366025403f;
+    const float G2 = 0.211324865f;
+    
+    F s = (x + y) * F2;
+    auto i = fastFloor(x + s);
+    auto j = fastFloor(y + s);
+    F t = toFloat(i + j) * G2;
+    F x0 = x - (toFloat(i) - t);
+    F y0 = y - (toFloat(j) - t);
+    
+    // lower or upper triangle of the cell
+    auto i1 = maskInt(x0 > y0);
+    auto j1 = 1 - i1;
+    F x1 = x0 - toFloat(i1) + G2;
+    F y1 = y0 - toFloat(j1) + G2;
+    F x2 = x0 - 1.0f + 2.0f * G2;
+    F y2 = y0 - 1.0f + 2.0f * G2;
+    
+    auto ii = i & 0xff;
+    auto jj = j & 0xff;
+    
+    F t0 = positive(0.5f - x0 * x0 - y0 * y0);
+    t0 *= t0;
+    F n0 = t0 * t0 * grad2(gather(perm, ii + gather(perm, jj)), x0, y0);
+    F t1 = positive(0.5f - x1 * x1 - y1 * y1);
+    t1 *= t1;
+    F n1 = t1 * t1 * grad2(gather(perm, ii + i1 + gather(perm, jj + j1)), x1, y1);
+    F t2 = positive(0.5f - x2 * x2 - y2 * y2);
+    t2 *= t2;
+    F n2 = t2 * t2 * grad2(gather(perm, ii + 1 + gather(perm, jj + 1)), x2, y2);
+    return 40.0f * (n0 + n1 + n2);
+}
+
+template<class F> static inline F simplex3(F x, F y, F z)
+{
+    const float F3 = 0.333333333f;
+    const float G3 = 0.166666667f;
+    
+    F s = (x + y + z) * F3;
+    auto i = fastFloor(x + s);
+    auto j = fastFloor(y + s);
+    auto k = fastFloor(z + s);
+    F t = toFloat(i + j + k) * G3;
+    F x0 = x - (toFloat(i) - t);
+    F y0 = y - (toFloat(j) - t);
+    F z0 = z - (toFloat(k) - t);
+    
+    // which of the 6 tetrahedra, the reference's if/else chain as masks
+    auto xy = x0 >= y0;
+    auto yz = y0 >= z0;
+    auto xz = x0 >= z0;
+    auto i1 = maskInt(xy && (yz || xz));
+    auto j1 = maskInt(!xy && yz);
+    auto k1 = maskInt(!yz && (!xy || !xz));
+    auto i2 = maskInt(xy || (yz && xz));
+    auto j2 = maskInt(!xy || yz);
+    auto k2 = maskInt((xy && !yz) || (!xy && (!yz || !xz)));
+    
+    F x1 = x0 - toFloat(i1) + G3;
+    F y1 = y0 - toFloat(j1) + G3;
+    F z1 = z0 - toFloat(k1) + G3;
+    F x2 = x0 - toFloat(i2) + 2.0f * G3;
+    F y2 = y0 - toFloat(j2) + 2.0f * G3;
+    F z2 = z0 - toFloat(k2) + 2.0f * G3;
+    F x3 = x0 - 1.0f + 3.0f * G3;
+    F y3 = y0 - 1.0f + 3.0f * G3;
+    F z3 = z0 - 1.0f + 3.0f * G3;
+    
+    auto ii = i & 0xff;
+    auto jj = j & 0xff;
+    auto kk = k & 0xff;
+    
+    F t0 = positive(0.6f - x0 * x0 - y0 * y0 - z0 * z0);
+    t0 *= t0;
+    F n0 = t0 * t0 * grad3(gather(perm, ii + gather(perm, jj + gather(perm, kk))), x0, y0, z0);
+    F t1 = positive(0.6f - x1 * x1 - y1 * y1 - z1 * z1);
+    t1 *= t1;
+    F n1 = t1 * t1 * grad3(gather(perm, ii + i1 + gather(perm, jj + j1 + gather(perm, kk + k1))), x1, y1, z1);
+    F t2 = positive(0.6f - x2 * x2 - y2 * y2 - z2 * z2);
+    t2 *= t2;
+    F n2 = t2 * t2 * grad3(gather(perm, ii + i2 + gather(perm, jj + j2 + gather(perm, kk + k2))), x2, y2, z2);
+    F t3 = positive(0.6f - x3 * x3 - y3 * y3 - z3 * z3);
+    t3 *= t3;
+    F n3 = t3 * t3 * grad3(gather(perm, ii + 1 + gather(perm, jj + 1 + gather(perm, kk + 1))), x3, y3, z3);
+    return 32.0f * (n0 + n1 + n2 + n3);
+}
+
+template<class F> static inline F simplex4(F x, F y, F z, F w)
+{
+    const float F4 = 0.309016994f;
+    const float G4 = 0.138196601f;
+    
+    F s = (x + y + z + w) * F4;
+    auto i = fastFloor(x + s);
+    auto j = fastFloor(y + s);
+    auto k = fastFloor(z + s);
+    auto l = fastFloor(w + s);
+    F t = toFloat(i + j + k + l) * G4;
+    F x0 = x - (toFloat(i) - t);
+    F y0 = y - (toFloat(j) - t);
+    F z0 = z - (toFloat(k) - t);
+    F w0 = w - (toFloat(l) - t);
+    
+    auto c = maskInt(x0 > y0) * 32 + maskInt(x0 > z0) * 16 + maskInt(y0 > z0) * 8 +
+             maskInt(x0 > w0) * 4 + maskInt(y0 > w0) * 2 + maskInt(z0 > w0);
+    auto rx = gather(simplexOrder, c * 4);
+    auto ry = gather(simplexOrder, c * 4 + 1);
+    auto rz = gather(simplexOrder, c * 4 + 2);
+    auto rw = gather(simplexOrder, c * 4 + 3);
+    auto i1 = maskInt(rx >= 3), j1 = maskInt(ry >= 3), k1 = maskInt(rz >= 3), l1 = maskInt(rw >= 3);
+    auto i2 = maskInt(rx >= 2), j2 = maskInt(ry >= 2), k2 = maskInt(rz >= 2), l2 = maskInt(rw >= 2);
+    auto i3 = maskInt(rx >= 1), j3 = maskInt(ry >= 1), k3 = maskInt(rz >= 1), l3 = maskInt(rw >= 1);
+    
+    F x1 = x0 - toFloat(i1) + G4;
+    F y1 = y0 - toFloat(j1) + G4;
+    F z1 = z0 - toFloat(k1) + G4;
+    F w1 = w0 - toFloat(l1) + G4;
+    F x2 = x0 - toFloat(i2) + 2.0f * G4;
+    F y2 = y0 - toFloat(j2) + 2.0f * G4;
+    F z2 = z0 - toFloat(k2) + 2.0f * G4;
+    F w2 = w0 - toFloat(l2) + 2.0f * G4;
+    F x3 = x0 - toFloat(i3) + 3.0f * G4;
+    F y3 = y0 - toFloat(j3) + 3.0f * G4;
+    F z3 = z0 - toFloat(k3) + 3.0f * G4;
+    F w3 = w0 - toFloat(l3) + 3.0f * G4;
+    F x4 = x0 - 1.0f + 4.0f * G4;
+    F y4 = y0 - 1.0f + 4.0f * G4;
+    F z4 = z0 - 1.0f + 4.0f * G4;
+    F w4 = w0 - 1.0f + 4.0f * G4;
+    
+    auto ii = i & 0xff;
+    auto jj = j & 0xff;
+    auto kk = k & 0xff;
+    auto ll = l & 0xff;
+    
+    F t0 = positive(0.6f - x0 * x0 - y0 * y0 - z0 * z0 - w0 * w0);
+    t0 *= t0;
+    F n0 = t0 * t0 * grad4(gather(perm, ii + gather(perm, jj + gather(perm, kk + gather(perm, ll)))), x0, y0, z0, w0);
+    F t1 = positive(0.6f - x1 * x1 - y1 * y1 - z1 * z1 - w1 * w1);
+    t1 *= t1;
+    F n1 = t1 * t1 * grad4(gather(perm, ii + i1 + gather(perm, jj + j1 + gather(perm, kk + k1 + gather(perm, ll + l1)))), x1, y1, z1, w1);
+    F t2 = positive(0.6f - x2 * x2 - y2 * y2 - z2 * z2 - w2 * w2);
+    t2 *= t2;
+    F n2 = t2 * t2 * grad4(gather(perm, ii + i2 + gather(perm, jj + j2 + gather(perm, kk + k2 + gather(perm, ll + l2)))), x2, y2, z2, w2);
+    F t3 = positive(0.6f - x3 * x3 - y3 * y3 - z3 * z3 - w3 * w3);
+    t3 *= t3;
+    F n3 = t3 * t3 * grad4(gather(perm, ii + i3 + gather(perm, jj + j3 + gather(perm, kk + k3 + gather(perm, ll + l3)))), x3, y3, z3, w3);
+    F t4 = positive(0.6f - x4 * x4 - y4 * y4 - z4 * z4 - w4 * w4);
+    t4 *= t4;
+    F n4 = t4 * t4 * grad4(gather(perm, ii + 1 + gather(perm, jj + 1 + gather(perm, kk + 1 + gather(perm, ll + 1)))), x4, y4, z4, w4);
+    return 27.0f * (n0 + n1 + n2 + n3 + n4);
+}
+
+// classic gradient noise, the corners of the cell blended with fade()
+
+template<class F> static inline F perlin1(F x)
+{
+    auto ix0 = floorInt(x);
+    F fx0 = x - toFloat(ix0);
+    F fx1 = fx0 - 1.0f;
+    auto ix1 = (ix0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    
+    return 0.188f * lerp(fade(fx0), grad1(gather(perm, ix0), fx0), grad1(gather(perm, ix1), fx1));
+}
+
+template<class F> static inline F perlin2(F x, F y)
+{
+    auto ix0 = floorInt(x), iy0 = floorInt(y);
+    F fx0 = x - toFloat(ix0), fy0 = y - toFloat(iy0);
+    F fx1 = fx0 - 1.0f, fy1 = fy0 - 1.0f;
+    auto ix1 = (ix0 + 1) & 0xff, iy1 = (iy0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    
+    auto corner = [&](bool bx, bool by)
+    {
+        return grad2(gather(perm, (bx ? ix1 : ix0) + gather(perm, by ? iy1 : iy0)), bx ? fx1 : fx0, by ? fy1 : fy0);
+    };
+    F t = fade(fy0);
+    F n0 = lerp(t, corner(false, false), corner(false, true));
+    F n1 = lerp(t, corner(true, false), corner(true, true));
+    return 0.507f * lerp(fade(fx0), n0, n1);
+}
+
+template<class F> static inline F perlin3(F x, F y, F z)
+{
+    auto ix0 = floorInt(x), iy0 = floorInt(y), iz0 = floorInt(z);
+    F fx0 = x - toFloat(ix0), fy0 = y - toFloat(iy0), fz0 = z - toFloat(iz0);
+    F fx1 = fx0 - 1.0f, fy1 = fy0 - 1.0f, fz1 = fz0 - 1.0f;
+    auto ix1 = (ix0 + 1) & 0xff, iy1 = (iy0 + 1) & 0xff, iz1 = (iz0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    iz0 = iz0 & 0xff;
+    
+    auto corner = [&](bool bx, bool by, bool bz)
+    {
+        auto hash = gather(perm, (bx ? ix1 : ix0) + gather(perm, (by ? iy1 : iy0) + gather(perm, bz ? iz1 : iz0)));
+        return grad3(hash, bx ? fx1 : fx0, by ? fy1 : fy0, bz ? fz1 : fz0);
+    };
+    F r = fade(fz0);
+    F t = fade(fy0);
+    auto edge = [&](bool bx, bool by) { return lerp(r, corner(bx, by, false), corner(bx, by, true)); };
+    F n0 = lerp(t, edge(false, false), edge(false, true));
+    F n1 = lerp(t, edge(true, false), edge(true, true));
+    return 0.936f * lerp(fade(fx0), n0, n1);
+}
+
+template<class F> static inline F perlin4(F x, F y, F z, F w)
+{
+    auto ix0 = floorInt(x), iy0 = floorInt(y), iz0 = floorInt(z), iw0 = floorInt(w);
+    F fx0 = x - toFloat(ix0), fy0 = y - toFloat(iy0), fz0 = z - toFloat(iz0), fw0 = w - toFloat(iw0);
+    F fx1 = fx0 - 1.0f, fy1 = fy0 - 1.0f, fz1 = fz0 - 1.0f, fw1 = fw0 - 1.0f;
+    auto ix1 = (ix0 + 1) & 0xff, iy1 = (iy0 + 1) & 0xff, iz1 = (iz0 + 1) & 0xff, iw1 = (iw0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    iz0 = iz0 & 0xff;
+    iw0 = iw0 & 0xff;
+    
+    auto corner = [&](bool bx, bool by, bool bz, bool bw)
+    {
+        auto hash = gather(perm, (bx ? ix1 : ix0) + gather(perm, (by ? iy1 : iy0) + gather(perm, (bz ? iz1 : iz0) + gather(perm, bw ? iw1 : iw0))));
+        return grad4(hash, bx ? fx1 : fx0, by ? fy1 : fy0, bz ? fz1 : fz0, bw ? fw1 : fw0);
+    };
+    F q = fade(fw0);
+    F r = fade(fz0);
+    F t = fade(fy0);
+    auto edge = [&](bool bx, bool by, bool bz) { return lerp(q, corner(bx, by, bz, false), corner(bx, by, bz, true)); };
+    auto face = [&](bool bx, bool by) { return lerp(r, edge(bx, by, false), edge(bx, by, true)); };
+    F n0 = lerp(t, face(false, false), face(false, true));
+    F n1 = lerp(t, face(true, false), face(true, true));
+    return 0.87f * lerp(fade(fx0), n0, n1);
+}
+
+// value noise, random lattice values in [-1, 1] blended with fade()
+
+template<class I> static inline auto latticeValue(I hash) -> decltype(toFloat(hash))
+{
+    return toFloat(gather(perm, hash)) * (2.0f / 255.0f) - 1.0f;
+}
+
+template<class F> static inline F value1(F x)
+{
+    auto ix0 = floorInt(x);
+    F fx0 = x - toFloat(ix0);
+    auto ix1 = (ix0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    return lerp(fade(fx0), latticeValue(ix0), latticeValue(ix1));
+}
+
+template<class F> static inline F value2(F x, F y)
+{
+    auto ix0 = floorInt(x), iy0 = floorInt(y);
+    F fx0 = x - toFloat(ix0), fy0 = y - toFloat(iy0);
+    auto ix1 = (ix0 + 1) & 0xff, iy1 = (iy0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    
+    auto corner = [&](bool bx, bool by) { return latticeValue((bx ? ix1 : ix0) + gather(perm, by ? iy1 : iy0)); };
+    F t = fade(fy0);
+    F n0 = lerp(t, corner(false, false), corner(false, true));
+    F n1 = lerp(t, corner(true, false), corner(true, true));
+    return lerp(fade(fx0), n0, n1);
+}
+
+template<class F> static inline F value3(F x, F y, F z)
+{
+    auto ix0 = floorInt(x), iy0 = floorInt(y), iz0 = floorInt(z);
+    F fx0 = x - toFloat(ix0), fy0 = y - toFloat(iy0), fz0 = z - toFloat(iz0);
+    auto ix1 = (ix0 + 1) & 0xff, iy1 = (iy0 + 1) & 0xff, iz1 = (iz0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    iz0 = iz0 & 0xff;
+    
+    auto corner = [&](bool bx, bool by, bool bz)
+    {
+        return latticeValue((bx ? ix1 : ix0) + gather(perm, (by ? iy1 : iy0) + gather(perm, bz ? iz1 : iz0)));
+    };
+    F r = fade(fz0);
+    F t = fade(fy0);
+    auto edge = [&](bool bx, bool by) { return lerp(r, corner(bx, by, false), corner(bx, by, true)); };
+    F n0 = lerp(t, edge(false, false), edge(false, true));
+    F n1 = lerp(t, edge(true, false), edge(true, true));
+    return lerp(fade(fx0), n0, n1);
+}
+
+template<class F> static inline F value4(F x, F y, F z, F w)
+{
+    auto ix0 = floorInt(x), iy0 = floorInt(y), iz0 = floorInt(z), iw0 = floorInt(w);
+    F fx0 = x - toFloat(ix0), fy0 = y - toFloat(iy0), fz0 = z - toFloat(iz0), fw0 = w - toFloat(iw0);
+    auto ix1 = (ix0 + 1) & 0xff, iy1 = (iy0 + 1) & 0xff, iz1 = (iz0 + 1) & 0xff, iw1 = (iw0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    iz0 = iz0 & 0xff;
+    iw0 = iw0 & 0xff;
+    
+    auto corner = [&](bool bx, bool by, bool bz, bool bw)
+    {
+        return latticeValue((bx ? ix1 : ix0) + gather(perm, (by ? iy1 : iy0) + gather(perm, (bz ? iz1 : iz0) + gather(perm, bw ? iw1 : iw0))));
+    };
+    F q = fade(fw0);
+    F r = fade(fz0);
+    F t = fade(fy0);
+    auto edge = [&](bool bx, bool by, bool bz) { return lerp(q, corner(bx, by, bz, false), corner(bx, by, bz, true)); };
+    auto face = [&](bool bx, bool by) { return lerp(r, edge(bx, by, false), edge(bx, by, true)); };
+    F n0 = lerp(t, face(false, false), face(false, true));
+    F n1 = lerp(t, face(true, false), face(true, true));
+    return lerp(fade(fx0), n0, n1);
+}
+
+template<class F> static inline F eval(DKNoiseType type, F x)
+{
+    if (type == DKNoiseType::DK_SIMPLEX) return simplex1(x);
+    if (type == DKNoiseType::DK_PERLIN) return perlin1(x);
+    return value1(x);
+}
+
+template<class F> static inline F eval(DKNoiseType type, F x, F y)
+{
+    if (type == DKNoiseType::DK_SIMPLEX) return simplex2(x, y);
+    if (type == DKNoiseType::DK_PERLIN) return perlin2(x, y);
+    return value2(x, y);
+}
+
+template<class F> static inline F eval(DKNoiseType type, F x, F y, F z)
+{
+    if (type == DKNoiseType::DK_SIMPLEX) return simplex3(x, y, z);
+    if (type == DKNoiseType::DK_PERLIN) return perlin3(x, y, z);
+    return value3(x, y, z);
+}
+
+template<class F> static inline F eval(DKNoiseType type, F x, F y, F z, F w)
+{
+    if (type == DKNoiseType::DK_SIMPLEX) return simplex4(x, y, z, w);
+    if (type == DKNoiseType::DK_PERLIN) return perlin4(x, y, z, w);
+    return value4(x, y, z, w);
+}
+
+// octaves of the 2d noise, the amplitudes normalize the sum back to [-1, 1]
+template<class F> static inline F fbm2(DKNoiseType type, F x, F y, int octaves, float lacunarity, float gain)
+{
+    F sum = 0.0f;
+    float amplitude = 1, frequency = 1, total = 0;
+    for (int o = 0; o < max(octaves, 1); o++)
+    {
+        sum += amplitude * eval(type, x * frequency, y * frequency);
+        total += amplitude;
+        amplitude *= gain;
+        frequency *= lacunarity;
+    }
+    return sum * (1.0f / total);
+}
+
+float DKNoise::noise(float x) { return simplex1(x) * 0.5f + 0.5f; }
+float DKNoise::noise(float x, float y) { return simplex2(x, y) * 0.5f + 0.5f; }
+float DKNoise::noise(float x, float y, float z) { return simplex3(x, y, z) * 0.5f + 0.5f; }
+float DKNoise::noise(float x, float y, float z, float w) { return simplex4(x, y, z, w) * 0.5f + 0.5f; }
+
+float DKNoise::simplex(float x) { return simplex1(x); }
+float DKNoise::simplex(float x, float y) { return simplex2(x, y); }
+float DKNoise::simplex(float x, float y, float z) { return simplex3(x, y, z); }
+float DKNoise::simplex(float x, float y, float z, float w) { return simplex4(x, y, z, w); }
+float DKNoise::perlin(float x) { return perlin1(x); }
+float DKNoise::perlin(float x, float y) { return perlin2(x, y); }
+float DKNoise::perlin(float x, float y, float z) { return perlin3(x, y, z); }
+float DKNoise::perlin(float x, float y, float z, float w) { return perlin4(x, y, z, w); }
+float DKNoise::value(float x) { return value1(x); }
+float DKNoise::value(float x, float y) { return value2(x, y); }
+float DKNoise::value(float x, float y, float z) { return value3(x, y, z); }
+float DKNoise::value(float x, float y, float z, float w) { return value4(x, y, z, w); }
+
+float DKNoise::fbm(DKNoiseType type, float x, int octaves, float lacunarity, float gain)
+{
+    float sum = 0, amplitude = 1, frequency = 1, total = 0;
+    for (int o = 0; o < max(octaves, 1); o++)
+    {
+        sum += amplitude * eval(type, x * frequency);
+        total += amplitude;
+        amplitude *= gain;
+        frequency *= lacunarity;
+    }
+    return sum / total;
+}
+
+float DKNoise::fbm(DKNoiseType type, float x, float y, int octaves, float lacunarity, float gain)
+{
+    return fbm2(type, x, y, octaves, lacunarity, gain);
+}
+
+float DKNoise::fbm(DKNoiseType type, float x, float y, float z, int octaves, float lacunarity, float gain)
+{
+    float sum = 0, amplitude = 1, frequency = 1, total = 0;
+    for (int o = 0; o < max(octaves, 1); o++)
+    {
+        sum += amplitude * eval(type, x * frequency, y * frequency, z * frequency);
+        total += amplitude;
+        amplitude *= gain;
+        frequency *= lacunarity;
+    }
+    return sum / total;
+}
+
+void DKNoise::batch(DKNoiseType type, const float * x, float * out, int count)
+{
+    int i = 0;
+#if defined(DK_NOISE_LANES)
+    for (; i + DK_NOISE_LANES <= count; i += DK_NOISE_LANES) store(out + i, eval(type, load(x + i)));
+#endif
+    for (; i < count; i++) out[i] = eval(type, x[i]);
+}
+
+void DKNoise::batch(DKNoiseType type, const float * x, const float * y, float * out, int count)
+{
+    int i = 0;
+#if defined(DK_NOISE_LANES)
+    for (; i + DK_NOISE_LANES <= count; i += DK_NOISE_LANES) store(out + i, eval(type, load(x + i), load(y + i)));
+#endif
+    for (; i < count; i++) out[i] = eval(type, x[i], y[i]);
+}
+
+void DKNoise::batch(DKNoiseType type, const float * x, const float * y, const float * z, float * out, int count)
+{
+    int i = 0;
+#if defined(DK_NOISE_LANES)
+    for (; i + DK_NOISE_LANES <= count; i += DK_NOISE_LANES) store(out + i, eval(type, load(x + i), load(y + i), load(z + i)));
+#endif
+    for (; i < count; i++) out[i] = eval(type, x[i], y[i], z[i]);
+}
+
+void DKNoise::batch(DKNoiseType type, const float * x, const float * y, const float * z, const float * w, float * out, int count)
+{
+    int i = 0;
+#if defined(DK_NOISE_LANES)
+    for (; i + DK_NOISE_LANES <= count; i += DK_NOISE_LANES) store(out + i, eval(type, load(x + i), load(y + i), load(z + i), load(w + i)));
+#endif
+    for (; i < count; i++) out[i] = eval(type, x[i], y[i], z[i], w[i]);
+}
+
+void DKNoise::fbm(DKNoiseType type, const float * x, const float * y, float * out, int count, int octaves, float lacunarity, float gain)
+{
+    int i = 0;
+#if defined(DK_NOISE_LANES)
+    for (; i + DK_NOISE_LANES <= count; i += DK_NOISE_LANES) store(out + i, fbm2(type, load(x + i), load(y + i), octaves, lacunarity, gain));
+#endif
+    for (; i < count; i++) out[i] = fbm2(type, x[i], y[i], octaves, lacunarity, gain);
+}
+
+void DKNoise::row(DKNoiseType type, float x, float dx, float y, float * out, int count)
+{
+    int i = 0;
+#if defined(DK_NOISE_LANES)
+    Lanes lanes = laneOffsets();
+    for (; i + DK_NOISE_LANES <= count; i += DK_NOISE_LANES) store(out + i, eval(type, Lanes(x) + (lanes + (float) i) * dx, Lanes(y)));
+#endif
+    for (; i < count; i++) out[i] = eval(type, x + i * dx, y);
+}
+
+void DKNoise::grid(DKNoiseType type, float x, float dx, float y, float dy, int cols, int rows, float * out)
+{
+    for (int r = 0; r < rows; r++) row(type, x, dx, y + r * dy, out + r * cols, cols);
+}
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKNoise_hpp
+#define DKNoise_hpp
+
+#include "ofMain.h"
+
+enum class DKNoiseType {
+    DK_SIMPLEX,
+    DK_PERLIN,
+    DK_VALUE
+};
+
+// Gradient and value noise in 1 to 4 dimensions. Simplex uses the same
+// tables and arithmetic as ofNoise, so noise() is a drop-in replacement for
+// it (and signed versions for ofSignedNoise); perlin is classic gradient
+// noise and value interpolates random lattice values. The signed variants
+// and every batch call return values in [-1, 1].
+//
+// Batch calls evaluate 8 samples per step with AVX2 or 4 with NEON when the
+// build enables them (see addon_config.mk), otherwise they fall back to the
+// scalar code.
+class DKNoise
+{
+public:
+    // ofNoise compatible, [0, 1]
+    static float noise(float);
+    static float noise(float, float);
+    static float noise(float, float, float);
+    static float noise(float, float, float, float);
+    
+    static float simplex(float);
+    static float simplex(float, float);
+    static float simplex(float, float, float);
+    static float simplex(float, float, float, float);
+    static float perlin(float);
+    static float perlin(float, float);
+    static float perlin(float, float, float);
+    static float perlin(float, float, float, float);
+    static float value(float);
+    static float value(float, float);
+    static float value(float, float, float);
+    static float value(float, float, float, float);
+    
+    // octaves summed with frequency * lacunarity and amplitude * gain,
+    // normalized back to [-1, 1]
+    static float fbm(DKNoiseType, float, int, float = 2.0, float = 0.5);
+    static float fbm(DKNoiseType, float, float, int, float = 2.0, float = 0.5);
+    static float fbm(DKNoiseType, float, float, float, int, float = 2.0, float = 0.5);
+    
+    // out[i] = noise at (x[i], y[i], ...) for i < count
+    static void batch(DKNoiseType, const float *, float *, int);
+    static void batch(DKNoiseType, const float *, const float *, float *, int);
+    static void batch(DKNoiseType, const float *, const float *, const float *, float *, int);
+    static void batch(DKNoiseType, const float *, const float *, const float *, const float *, float *, int);
+    static void fbm(DKNoiseType, const float *, const float *, float *, int, int, float = 2.0, float = 0.5);
+    
+    // out[i] = noise at (x + i * dx, y), one row of a heightfield
+    static void row(DKNoiseType, float, float, float, float *, int);
+    // cols * rows samples starting at (x, y), row major
+    static void grid(DKNoiseType, float, float, float, float, int, int, float *);
+};
+
+#endif /* DKNoise_hpp */
@@ -0,0 +1,165 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKPresetBank.hpp"
+
+DKPresetBank::DKPresetBank()
+{
+    stride = 0;
+    lastMorph = -1;
+}
+
+void DKPresetBank::attach(ofxDatGui * gui, string excluded)
+{
+    unordered_map<string, ofxDatGuiSlider*> found;
+    vector<ofxDatGuiSlider*> ordered;
+    
+    for (auto component : gui->getItems())
+    {
+        vector<ofxDatGuiComponent*> items = { component };
+        if (component->children.size() > 0) items = component->children;
+        for (auto item : items)
+        {
+            if (item->getType() != ofxDatGuiType::SLIDER || item->getName() == excluded) continue;
+            ofxDatGuiSlider * slider = static_cast<ofxDatGuiSlider*>(item);
+            found.insert({ slider->getName(), slider });
+            ordered.push_back(slider);
+        }
+    }
+    
+    // known parameters keep their index, new ones are appended
+    sliders.assign(parameterNames.size(), nullptr);
+    for (int i = 0; i < parameterNames.size(); i++)
+    {
+        auto it = found.find(parameterNames[i]);
+        if (it == found.end()) continue;
+        sliders[i] = it->second;
+        found.erase(it);
+    }
+    for (auto slider : ordered)
+    {
+        if (found.count(slider->getName()) == 0) continue;
+        found.erase(slider->getName());
+        parameterNames.push_back(slider->getName());
+        sliders.push_back(slider);
+    }
+    
+    int newStride = (parameterNames.size() + 3) & ~3;
+    if (newStride != stride)
+    {
+        vector<float> resized(presetNames.size() * newStride, 0.0);
+        for (int p = 0; p < presetNames.size(); p++)
+            for (int i = 0; i < MIN(stride, newStride); i++)
+                resized[p * newStride + i] = values[p * stride + i];
+        values.swap(resized);
+        stride = newStride;
+    }
+    current.assign(stride, 0.0);
+    applied.assign(stride, -1.0);
+    lastMorph = -1;
+}
+
+void DKPresetBank::detach()
+{
+    sliders.clear();
+}
+
+int DKPresetBank::save(string name)
+{
+    presetNames.push_back(name);
+    values.resize(presetNames.size() * stride, 0.0);
+    
+    float * row = getRow(presetNames.size() - 1);
+    for (int i = 0; i < sliders.size(); i++)
+    {
+        if (sliders[i] != nullptr) row[i] = sliders[i]->getComponentScale();
+        applied[i] = row[i];
+    }
+    return presetNames.size() - 1;
+}
+
+void DKPresetBank::recall(int preset)
+{
+    if (preset < 0 || preset >= presetNames.size()) return;
+    
+    const float * row = getRow(preset);
+    std::copy(row, row + stride, current.begin());
+    apply();
+}
+
+void DKPresetBank::morph(int a, int b, float t)
+{
+    if (a < 0 || b < 0 || a >= presetNames.size() || b >= presetNames.size()) return;
+    
+    const float * __restrict from = getRow(a);
+    const float * __restrict to = getRow(b);
+    float * __restrict out = current.data();
+    
+    for (int i = 0; i < stride; i++)
+    {
+        out[i] = from[i] + (to[i] - from[i]) * t;
+    }
+    apply();
+}
+
+void DKPresetBank::morph(float position)
+{
+    // position 0..1 walks through every preset in the order they were saved
+    if (presetNames.size() < 2 || position == lastMorph) return;
+    lastMorph = position;
+    
+    float p = ofClamp(position, 0.0, 1.0) * (presetNames.size() - 1);
+    int a = MIN((int) p, (int) presetNames.size() - 2);
+    morph(a, a + 1, p - a);
+}
+
+void DKPresetBank::apply()
+{
+    // only sliders whose value actually moved get their bound variables written
+    for (int i = 0; i < sliders.size(); i++)
+    {
+        if (sliders[i] == nullptr || current[i] == applied[i]) continue;
+        sliders[i]->setComponentScale(current[i]);
+        applied[i] = current[i];
+    }
+}
+
+float * DKPresetBank::getRow(int preset)
+{
+    return values.data() + preset * stride;
+}
+
+int DKPresetBank::getNumPresets()
+{
+    return presetNames.size();
+}
+
+int DKPresetBank::getNumParameters()
+{
+    return parameterNames.size();
+}
+
+string DKPresetBank::getPresetName(int preset)
+{
+    return presetNames[preset];
+}
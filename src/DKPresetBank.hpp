@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKPresetBank_hpp
+#define DKPresetBank_hpp
+
+#include "ofMain.h"
+#include "ofxDatGui.h"
+
+// Snapshots of every slider of a gui stored as normalized values in one
+// flat array, one row per preset. Sliders are indexed once in attach(), so
+// recall and morph never look anything up by name.
+class DKPresetBank
+{
+public:
+    DKPresetBank();
+    
+    void attach(ofxDatGui *, string);
+    void detach();
+    
+    int save(string);
+    void recall(int);
+    void morph(int, int, float);
+    void morph(float);
+    
+    int getNumPresets();
+    int getNumParameters();
+    string getPresetName(int);
+    
+private:
+    void apply();
+    float * getRow(int);
+    
+    vector<ofxDatGuiSlider*> sliders;
+    vector<string> parameterNames;
+    vector<string> presetNames;
+    
+    // presets * stride floats, rows padded to 4 so the lerp loop vectorizes
+    vector<float> values;
+    vector<float> current;
+    vector<float> applied;
+    int stride;
+    float lastMorph;
+};
+
+#endif /* DKPresetBank_hpp */
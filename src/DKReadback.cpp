@@ -0,0 +1,193 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "DKReadback.hpp"
+
+DKReadback::DKReadback()
+{
+    fbo = nullptr;
+    writeIndex = readIndex = droppedFrames = 0;
+    mappedIndex = -1;
+    useFences = false;
+    width = height = 0;
+    format = GL_RGBA;
+    type = GL_UNSIGNED_BYTE;
+    frameSize = 0;
+}
+
+DKReadback::~DKReadback()
+{
+    clear();
+}
+
+void DKReadback::setup(ofFbo* fboptr)
+{
+    setup(fboptr, 3);
+}
+
+void DKReadback::setup(ofFbo* fboptr, int numBuffers)
+{
+    clear();
+    fbo = fboptr;
+    if (fbo == nullptr || !fbo->isAllocated()) return;
+    
+    ofTexture& tex = fbo->getTexture();
+    GLint internalFormat = tex.getTextureData().glInternalFormat;
+    width = tex.getWidth();
+    height = tex.getHeight();
+    format = ofGetGLFormatFromInternal(internalFormat);
+    type = ofGetGLTypeFromInternal(internalFormat);
+    frameSize = (size_t) width * height * ofGetNumChannelsFromGLFormat(format) * ofGetBytesPerChannelFromGLType(type);
+    
+    slots.resize(MAX(numBuffers, 2));
+    for (auto& slot : slots)
+    {
+        slot.buffer.allocate(frameSize, GL_STREAM_READ);
+    }
+    
+    // without sync objects a copy is considered done once the ring wrapped around
+    useFences = ofIsGLProgrammableRenderer() || ofGLCheckExtension("GL_ARB_sync");
+}
+
+void DKReadback::clear()
+{
+    unmap();
+    for (auto& slot : slots) release(slot);
+    slots.clear();
+    writeIndex = readIndex = 0;
+}
+
+void DKReadback::update()
+{
+    if (fbo == nullptr || slots.empty()) return;
+    
+    if (fbo->getWidth() != width || fbo->getHeight() != height)
+    {
+        setup(fbo, slots.size());
+    }
+    
+    Slot& slot = slots[writeIndex];
+    if (slot.pending)
+    {
+        // the consumer didn't keep up, the ring is full
+        droppedFrames++;
+        if (mappedIndex == (int) writeIndex) return;
+        release(slot);
+        readIndex = (writeIndex + 1) % slots.size();
+    }
+    
+    fbo->getTexture().copyTo(slot.buffer);
+    if (useFences)
+    {
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    slot.frameNum = ofGetFrameNum();
+    slot.pending = true;
+    writeIndex = (writeIndex + 1) % slots.size();
+}
+
+bool DKReadback::isReady(Slot& slot)
+{
+    if (!slot.pending) return false;
+    if (useFences)
+    {
+        GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+    return ofGetFrameNum() - slot.frameNum >= slots.size() - 1;
+}
+
+void DKReadback::release(Slot& slot)
+{
+    if (slot.fence != 0)
+    {
+        glDeleteSync(slot.fence);
+        slot.fence = 0;
+    }
+    slot.pending = false;
+}
+
+bool DKReadback::map(DKReadbackFrame& frame)
+{
+    unmap();
+    if (slots.empty()) return false;
+    
+    Slot& slot = slots[readIndex];
+    if (!isReady(slot)) return false;
+    
+    void* data = slot.buffer.map(GL_READ_ONLY);
+    if (data == nullptr) return false;
+    
+    mappedIndex = readIndex;
+    frame.data = data;
+    frame.size = frameSize;
+    frame.width = width;
+    frame.height = height;
+    frame.format = format;
+    frame.type = type;
+    frame.frameNum = slot.frameNum;
+    return true;
+}
+
+void DKReadback::unmap()
+{
+    if (mappedIndex < 0) return;
+    
+    Slot& slot = slots[mappedIndex];
+    slot.buffer.unmap();
+    release(slot);
+    readIndex = (mappedIndex + 1) % slots.size();
+    mappedIndex = -1;
+}
+
+bool DKReadback::readToPixels(ofPixels& pixels)
+{
+    DKReadbackFrame frame;
+    if (type != GL_UNSIGNED_BYTE || !map(frame)) return false;
+    pixels.setFromPixels((const unsigned char*) frame.data, width, height, ofGetNumChannelsFromGLFormat(format));
+    unmap();
+    return true;
+}
+
+bool DKReadback::readToPixels(ofFloatPixels& pixels)
+{
+    DKReadbackFrame frame;
+    if (type != GL_FLOAT || !map(frame)) return false;
+    pixels.setFromPixels((const float*) frame.data, width, height, ofGetNumChannelsFromGLFormat(format));
+    unmap();
+    return true;
+}
+
+bool DKReadback::isAttached()
+{
+    return fbo != nullptr;
+}
+
+unsigned DKReadback::getDroppedFrames()
+{
+    return droppedFrames;
+}
+
+unsigned DKReadback::getNumBuffers()
+{
+    return slots.size();
+}
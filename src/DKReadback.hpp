@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef DKReadback_hpp
+#define DKReadback_hpp
+
+#include "ofMain.h"
+
+// mapped view into a readback buffer, valid until DKReadback::unmap()
+struct DKReadbackFrame
+{
+    const void* data = nullptr;
+    size_t size = 0;
+    int width = 0;
+    int height = 0;
+    GLenum format = GL_RGBA;
+    GLenum type = GL_UNSIGNED_BYTE;
+    uint64_t frameNum = 0;
+};
+
+// Ring of pixel pack buffers attached to an fbo. update() queues a copy of
+// the current frame, map() hands out the oldest copy the GPU has finished
+// without ever waiting on it. With the default 3 buffers the pixels you get
+// are usually from frame N-2.
+class DKReadback
+{
+public:
+    DKReadback();
+    ~DKReadback();
+    
+    void setup(ofFbo*);
+    void setup(ofFbo*, int);
+    void update();
+    void clear();
+    
+    bool map(DKReadbackFrame&);
+    void unmap();
+    bool readToPixels(ofPixels&);
+    bool readToPixels(ofFloatPixels&);
+    
+    bool isAttached();
+    unsigned getDroppedFrames();
+    unsigned getNumBuffers();
+    
+private:
+    struct Slot
+    {
+        ofBufferObject buffer;
+        GLsync fence = 0;
+        uint64_t frameNum = 0;
+        bool pending = false;
+    };
+    
+    bool isReady(Slot&);
+    void release(Slot&);
+    
+    ofFbo* fbo;
+    vector<Slot> slots;
+    unsigned writeIndex;
+    unsigned readIndex;
+    int mappedIndex;
+    unsigned droppedFrames;
+    bool useFences;
+    
+    int width;
+    int height;
+    GLenum format;
+    GLenum type;
+    size_t frameSize;
+};
+
+#endif /* DKReadback_hpp */
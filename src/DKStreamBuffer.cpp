@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKStreamBuffer.hpp"
+
+DKStreamBuffer::DKStreamBuffer()
+{
+    regionSize = 0;
+    region = 0;
+    persistent = false;
+    mapped = nullptr;
+    for (int i = 0; i < DK_STREAM_REGIONS; i++) fences[i] = nullptr;
+}
+
+DKStreamBuffer::~DKStreamBuffer()
+{
+    release();
+}
+
+void DKStreamBuffer::allocate(size_t bytes)
+{
+    release();
+    // regions stay aligned for any vertex or index type
+    regionSize = (bytes + 255) & ~(size_t) 255;
+    region = 0;
+    persistent = ofGLCheckExtension("GL_ARB_buffer_storage");
+    
+    if (persistent)
+    {
+        // immutable storage, mapped for the lifetime of the buffer
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        buffer.allocate();
+        buffer.bind(GL_ARRAY_BUFFER);
+        glBufferStorage(GL_ARRAY_BUFFER, regionSize * DK_STREAM_REGIONS, nullptr, flags);
+        mapped = (uint8_t*) glMapBufferRange(GL_ARRAY_BUFFER, 0, regionSize * DK_STREAM_REGIONS, flags);
+        buffer.unbind(GL_ARRAY_BUFFER);
+        if (mapped == nullptr) persistent = false;
+    }
+    if (!persistent)
+    {
+        buffer.allocate(regionSize, GL_STREAM_DRAW);
+    }
+}
+
+void DKStreamBuffer::reserve(size_t bytes)
+{
+    // only grows, steady state never reallocates
+    if (bytes > regionSize) allocate(max(bytes, regionSize + regionSize / 2));
+}
+
+void * DKStreamBuffer::mapRegion()
+{
+    if (!persistent)
+    {
+        buffer.setData(regionSize, nullptr, GL_STREAM_DRAW);
+        return buffer.map(GL_WRITE_ONLY);
+    }
+    
+    region = (region + 1) % DK_STREAM_REGIONS;
+    if (fences[region] != nullptr)
+    {
+        // only blocks if the gpu is still reading this region from 3 frames ago
+        while (glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) { }
+        glDeleteSync(fences[region]);
+        fences[region] = nullptr;
+    }
+    return mapped + region * regionSize;
+}
+
+void DKStreamBuffer::unmap()
+{
+    if (!persistent) buffer.unmap();
+}
+
+void DKStreamBuffer::fence()
+{
+    if (!persistent) return;
+    if (fences[region] != nullptr) glDeleteSync(fences[region]);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+ofBufferObject & DKStreamBuffer::getBuffer()
+{
+    return buffer;
+}
+
+size_t DKStreamBuffer::getOffset()
+{
+    return persistent ? region * regionSize : 0;
+}
+
+size_t DKStreamBuffer::getSize()
+{
+    return regionSize;
+}
+
+bool DKStreamBuffer::isPersistent()
+{
+    return persistent;
+}
+
+bool DKStreamBuffer::isAllocated()
+{
+    return regionSize > 0;
+}
+
+void DKStreamBuffer::release()
+{
+    for (int i = 0; i < DK_STREAM_REGIONS; i++)
+    {
+        if (fences[i] != nullptr) glDeleteSync(fences[i]);
+        fences[i] = nullptr;
+    }
+    if (persistent && mapped != nullptr)
+    {
+        buffer.bind(GL_ARRAY_BUFFER);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        buffer.unbind(GL_ARRAY_BUFFER);
+    }
+    mapped = nullptr;
+    // a fresh buffer object, immutable storage can't be respecified
+    buffer = ofBufferObject();
+}
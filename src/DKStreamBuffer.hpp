@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKStreamBuffer_hpp
+#define DKStreamBuffer_hpp
+
+#include "ofMain.h"
+
+#define DK_STREAM_REGIONS 3
+
+// A vertex or index buffer rewritten every frame. With ARB_buffer_storage it
+// is mapped once, persistently, and split into three regions used round
+// robin, each guarded by a fence; older GL orphans and maps the whole
+// buffer instead. Either way the generator writes straight into GL memory:
+//
+//   T * out = stream.map<T>();  ...write...  stream.unmap();
+//   vbo.setVertexBuffer(stream.getBuffer(), 3, stride, stream.getOffset());
+//   ...draw...
+//   stream.fence();
+class DKStreamBuffer
+{
+public:
+    DKStreamBuffer();
+    ~DKStreamBuffer();
+    
+    void allocate(size_t);
+    void reserve(size_t);
+    
+    template<typename T> T * map() { return (T*) mapRegion(); }
+    void unmap();
+    void fence();
+    
+    ofBufferObject & getBuffer();
+    size_t getOffset();
+    size_t getSize();
+    bool isPersistent();
+    bool isAllocated();
+    
+private:
+    void * mapRegion();
+    void release();
+    
+    ofBufferObject buffer;
+    size_t regionSize;
+    int region;
+    bool persistent;
+    uint8_t * mapped;
+    GLsync fences[DK_STREAM_REGIONS];
+};
+
+#endif /* DKStreamBuffer_hpp */
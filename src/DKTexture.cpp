@@ -0,0 +1,224 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "DKTexture.hpp"
+
+ofFbo::Settings DKTexture::getFboSettings(int width, int height, DKTextureProfile profile)
+{
+    return getFboSettings(width, height, profile, GL_RGBA);
+}
+
+ofFbo::Settings DKTexture::getFboSettings(int width, int height, DKTextureProfile profile, GLint internalformat)
+{
+    ofFbo::Settings s;
+    s.width = width;
+    s.height = height;
+    s.internalformat = internalformat;
+    
+    if (profile == DKTextureProfile::DK_MIPMAP_2D)
+    {
+        // the min filter switches to GL_LINEAR_MIPMAP_LINEAR once the first
+        // mipmap is built, before that the texture would be incomplete
+        s.textureTarget = GL_TEXTURE_2D;
+    }
+    else
+    {
+        s.textureTarget = GL_TEXTURE_RECTANGLE_ARB;
+    }
+    return s;
+}
+
+DKTextureProfile DKTexture::getProfile(ofTexture& tex)
+{
+    return tex.getTextureData().textureTarget == GL_TEXTURE_2D ?
+        DKTextureProfile::DK_MIPMAP_2D : DKTextureProfile::DK_RECTANGLE;
+}
+
+string DKTexture::getShaderHeader(DKTextureProfile profile)
+{
+    ostringstream oss;
+    oss << "#version 120" << endl;
+    if (profile == DKTextureProfile::DK_MIPMAP_2D)
+    {
+        oss << "#define SAMPLER_TYPE sampler2D" << endl;
+        oss << "#define TEXTURE_FN texture2D" << endl;
+        oss << "#define TEXTURE_PX(tex, px, size) texture2D(tex, (px) / (size))" << endl;
+        oss << "#define TEXTURE_UV(tex, uv, size) texture2D(tex, uv)" << endl;
+    }
+    else
+    {
+        oss << "#extension GL_ARB_texture_rectangle : enable" << endl;
+        oss << "#define SAMPLER_TYPE sampler2DRect" << endl;
+        oss << "#define TEXTURE_FN texture2DRect" << endl;
+        oss << "#define TEXTURE_PX(tex, px, size) texture2DRect(tex, px)" << endl;
+        oss << "#define TEXTURE_UV(tex, uv, size) texture2DRect(tex, (uv) * (size))" << endl;
+    }
+    return oss.str();
+}
+
+glm::vec2 DKTexture::getCoordScale(ofTexture& tex)
+{
+    if (getProfile(tex) == DKTextureProfile::DK_MIPMAP_2D)
+    {
+        return glm::vec2(1.0, 1.0);
+    }
+    return glm::vec2(tex.getWidth(), tex.getHeight());
+}
+
+// several consumers can ask for mipmaps of the same fbo,
+// build them at most once per frame
+static unordered_map<GLuint, uint64_t> lastMipmapFrame;
+
+void DKTexture::generateMipmap(ofFbo& fbo)
+{
+    ofTexture& tex = fbo.getTexture();
+    if (getProfile(tex) != DKTextureProfile::DK_MIPMAP_2D) return;
+    
+    GLuint textureId = tex.getTextureData().textureID;
+    uint64_t frame = ofGetFrameNum();
+    auto it = lastMipmapFrame.find(textureId);
+    if (it != lastMipmapFrame.end() && it->second == frame) return;
+    
+    tex.generateMipmap();
+    if (tex.getTextureData().minFilter != GL_LINEAR_MIPMAP_LINEAR)
+    {
+        tex.setTextureMinMagFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+    }
+    lastMipmapFrame[textureId] = frame;
+}
+
+int DKTexture::getNumMipLevels(ofTexture& tex)
+{
+    if (getProfile(tex) != DKTextureProfile::DK_MIPMAP_2D) return 1;
+    return 1 + (int) floor(log2(MAX(tex.getWidth(), tex.getHeight())));
+}
+
+void DKTexture::drawMipLevel(ofFbo& fbo, int level, float x, float y, float w, float h)
+{
+    ofTexture& tex = fbo.getTexture();
+    if (level <= 0 || getProfile(tex) != DKTextureProfile::DK_MIPMAP_2D)
+    {
+        fbo.draw(x, y, w, h);
+        return;
+    }
+    
+    generateMipmap(fbo);
+    level = MIN(level, getNumMipLevels(tex) - 1);
+    
+    GLuint textureId = tex.getTextureData().textureID;
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    fbo.draw(x, y, w, h);
+    
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+static unordered_map<const ofFbo*, uint64_t> fboGenerations;
+
+void DKTexture::touch(ofFbo& fbo)
+{
+    fboGenerations[&fbo]++;
+}
+
+uint64_t DKTexture::getGeneration(ofFbo& fbo)
+{
+    auto it = fboGenerations.find(&fbo);
+    return it != fboGenerations.end() ? it->second : 0;
+}
+
+void DKTexture::release(ofFbo& fbo)
+{
+    if (fbo.isAllocated())
+    {
+        lastMipmapFrame.erase(fbo.getTexture().getTextureData().textureID);
+    }
+    fboGenerations.erase(&fbo);
+}
+
+void DKShaderVariants::setupFromSource(string fragSource)
+{
+    compile(rectangle, DKTextureProfile::DK_RECTANGLE, "", fragSource);
+    compile(mipmap2D, DKTextureProfile::DK_MIPMAP_2D, "", fragSource);
+}
+
+// the vertex stage gets the sampler macros too, for vertex texture fetches
+void DKShaderVariants::setupFromSource(string vertSource, string fragSource)
+{
+    compile(rectangle, DKTextureProfile::DK_RECTANGLE, DKTexture::getShaderHeader(DKTextureProfile::DK_RECTANGLE) + vertSource, fragSource);
+    compile(mipmap2D, DKTextureProfile::DK_MIPMAP_2D, DKTexture::getShaderHeader(DKTextureProfile::DK_MIPMAP_2D) + vertSource, fragSource);
+}
+
+void DKShaderVariants::load(string path)
+{
+    string vertSource = "";
+    ofFile vertFile(path + ".vert");
+    if (vertFile.exists())
+    {
+        vertSource = ofBufferFromFile(path + ".vert").getText();
+    }
+    string fragSource = ofBufferFromFile(path + ".frag").getText();
+    
+    compile(rectangle, DKTextureProfile::DK_RECTANGLE, vertSource, fragSource);
+    compile(mipmap2D, DKTextureProfile::DK_MIPMAP_2D, vertSource, fragSource);
+}
+
+void DKShaderVariants::bindAttribute(GLuint location, string name)
+{
+    attributes.push_back({ location, name });
+}
+
+void DKShaderVariants::compile(ofShader& shader, DKTextureProfile profile, string vertSource, string fragSource)
+{
+    if (vertSource != "")
+    {
+        shader.setupShaderFromSource(GL_VERTEX_SHADER, vertSource);
+    }
+    shader.setupShaderFromSource(GL_FRAGMENT_SHADER, DKTexture::getShaderHeader(profile) + fragSource);
+    for (auto & attribute : attributes) shader.bindAttribute(attribute.first, attribute.second);
+    shader.linkProgram();
+}
+
+ofShader& DKShaderVariants::get(ofTexture& tex)
+{
+    if (DKTexture::getProfile(tex) == DKTextureProfile::DK_MIPMAP_2D)
+    {
+        return mipmap2D;
+    }
+    return rectangle;
+}
+
+ofShader& DKShaderVariants::get(ofFbo& fbo)
+{
+    return get(fbo.getTexture());
+}
+
+// for draws that don't bind any texture
+ofShader& DKShaderVariants::get()
+{
+    return rectangle;
+}
@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef DKTexture_hpp
+#define DKTexture_hpp
+
+#include "ofMain.h"
+
+// DK_RECTANGLE is the classic GL_TEXTURE_RECTANGLE_ARB fbo sampled in pixels,
+// DK_MIPMAP_2D is a normalized GL_TEXTURE_2D fbo that can build mipmaps on demand
+enum class DKTextureProfile {
+    DK_RECTANGLE,
+    DK_MIPMAP_2D
+};
+
+class DKTexture
+{
+public:
+    static ofFbo::Settings getFboSettings(int, int, DKTextureProfile);
+    static ofFbo::Settings getFboSettings(int, int, DKTextureProfile, GLint);
+    static DKTextureProfile getProfile(ofTexture&);
+    
+    // #version line plus SAMPLER_TYPE, TEXTURE_FN, TEXTURE_PX and TEXTURE_UV macros
+    static string getShaderHeader(DKTextureProfile);
+    static glm::vec2 getCoordScale(ofTexture&);
+    
+    static void generateMipmap(ofFbo&);
+    static int getNumMipLevels(ofTexture&);
+    static void drawMipLevel(ofFbo&, int, float, float, float, float);
+    
+    // producers bump the generation after rendering so caches can skip unchanged frames,
+    // 0 means the fbo's producer doesn't report generations
+    static void touch(ofFbo&);
+    static uint64_t getGeneration(ofFbo&);
+    
+    // forget the bookkeeping of an fbo before it is reallocated or deleted,
+    // GL reuses texture ids
+    static void release(ofFbo&);
+};
+
+// the same fragment source compiled once per sampler type,
+// get() returns the program matching the texture it will read from
+class DKShaderVariants
+{
+public:
+    void setupFromSource(string);
+    void setupFromSource(string, string);
+    void load(string);
+    // fixed attribute locations, call before setupFromSource or load
+    void bindAttribute(GLuint, string);
+    ofShader& get(ofTexture&);
+    ofShader& get(ofFbo&);
+    ofShader& get();
+private:
+    void compile(ofShader&, DKTextureProfile, string, string);
+    ofShader rectangle;
+    ofShader mipmap2D;
+    vector<pair<GLuint, string>> attributes;
+};
+
+#endif /* DKTexture_hpp */
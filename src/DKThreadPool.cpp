@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKThreadPool.hpp"
+
+DKThreadPool & DKThreadPool::get()
+{
+    static DKThreadPool pool;
+    return pool;
+}
+
+DKThreadPool::DKThreadPool()
+{
+    job = nullptr;
+    jobCount = jobGrain = numChunks = 0;
+    nextChunk = finishedChunks = 0;
+    activeWorkers = 0;
+    generation = 0;
+    running = true;
+    
+    // the caller always takes part, so one thread less than cores
+    int numWorkers = max((int) std::thread::hardware_concurrency() - 1, 0);
+    for (int i = 0; i < numWorkers; i++) threads.push_back(std::thread(&DKThreadPool::work, this));
+}
+
+DKThreadPool::~DKThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+    for (auto & thread : threads) thread.join();
+}
+
+void DKThreadPool::parallelFor(int count, int grain, const std::function<void(int, int)> & fn)
+{
+    if (count <= 0) return;
+    grain = max(grain, 1);
+    if (count <= grain || threads.empty())
+    {
+        fn(0, count);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        jobGrain = grain;
+        numChunks = (count + grain - 1) / grain;
+        finishedChunks = 0;
+        nextChunk = 0;
+        generation++;
+    }
+    wake.notify_all();
+    
+    runChunks();
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return finishedChunks == numChunks && activeWorkers == 0; });
+}
+
+int DKThreadPool::getNumThreads()
+{
+    return threads.size() + 1;
+}
+
+void DKThreadPool::work()
+{
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait(lock, [&] { return !running || generation != seen; });
+        if (!running) return;
+        seen = generation;
+        // woke up after the job was already finished by the others
+        if (finishedChunks == numChunks) continue;
+        
+        activeWorkers++;
+        lock.unlock();
+        runChunks();
+        lock.lock();
+        if (--activeWorkers == 0) done.notify_all();
+    }
+}
+
+void DKThreadPool::runChunks()
+{
+    int chunk;
+    while ((chunk = nextChunk++) < numChunks)
+    {
+        int begin = chunk * jobGrain;
+        (*job)(begin, min(begin + jobGrain, jobCount));
+        if (++finishedChunks == numChunks)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKThreadPool_hpp
+#define DKThreadPool_hpp
+
+#include "ofMain.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// One set of worker threads shared by every module. parallelFor splits
+// [0, count) into chunks of grain items; the calling thread works on chunks
+// too and returns once all of them are done.
+class DKThreadPool
+{
+public:
+    static DKThreadPool & get();
+    ~DKThreadPool();
+    
+    void parallelFor(int, int, const std::function<void(int, int)> &);
+    int getNumThreads();
+    
+private:
+    DKThreadPool();
+    void work();
+    void runChunks();
+    
+    vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    
+    const std::function<void(int, int)> * job;
+    int jobCount;
+    int jobGrain;
+    int numChunks;
+    std::atomic<int> nextChunk;
+    std::atomic<int> finishedChunks;
+    // workers inside runChunks, a new job only starts once this is 0
+    int activeWorkers;
+    uint64_t generation;
+    bool running;
+};
+
+#endif /* DKThreadPool_hpp */
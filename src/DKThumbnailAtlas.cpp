@@ -0,0 +1,220 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "DKThumbnailAtlas.hpp"
+
+DKThumbnailAtlas::DKThumbnailAtlas()
+{
+    cellWidth = 160;
+    cellHeight = 90;
+    columns = 4;
+    rows = 4;
+    firstResident = 0;
+    numResident = columns * rows;
+}
+
+DKThumbnailAtlas::~DKThumbnailAtlas()
+{
+    requests.close();
+    results.close();
+    waitForThread(true);
+}
+
+int DKThumbnailAtlas::add(string fileName)
+{
+    int item = fileNames.size();
+    fileNames.push_back(fileName);
+    loaded.push_back(false);
+    requested.push_back(false);
+    
+    if (!isThreadRunning()) startThread();
+    setResident(firstResident, numResident);
+    return item;
+}
+
+void DKThumbnailAtlas::setResident(int first, int count)
+{
+    firstResident = MAX(first, 0);
+    numResident = ofClamp(count, 0, getCapacity());
+    
+    for (int i = 0; i < fileNames.size(); i++)
+    {
+        if (isResident(i))
+        {
+            if (requested[i]) continue;
+            requested[i] = true;
+            requests.send({ i, fileNames[i] });
+        }
+        else
+        {
+            // evicted cells get decoded again when they scroll back in
+            requested[i] = loaded[i] = false;
+        }
+    }
+}
+
+void DKThumbnailAtlas::threadedFunction()
+{
+    Request request;
+    while (requests.receive(request))
+    {
+        Result result;
+        result.item = request.item;
+        if (!ofLoadImage(result.pixels, request.fileName))
+        {
+            ofLogWarning("DKThumbnailAtlas") << "couldn't load " << request.fileName;
+            result.pixels.allocate(cellWidth, cellHeight, OF_PIXELS_RGBA);
+            result.pixels.setColor(ofColor(66, 66, 74));
+        }
+        result.pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+        result.pixels.resize(cellWidth, cellHeight);
+        results.send(std::move(result));
+    }
+}
+
+bool DKThumbnailAtlas::update()
+{
+    if (fileNames.empty()) return false;
+    
+    if (!atlas.isAllocated())
+    {
+        atlas.allocate(columns * cellWidth, rows * cellHeight, GL_RGBA);
+        atlas.setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+    }
+    
+    // results for items that scrolled out or already got a live frame are dropped
+    vector<Result> ready;
+    Result result;
+    while (results.tryReceive(result))
+    {
+        if (isResident(result.item) && requested[result.item] && !loaded[result.item]) ready.push_back(std::move(result));
+    }
+    if (ready.empty()) return false;
+    
+    // one orphaned buffer per frame holds every cell that arrived
+    size_t cellSize = cellWidth * cellHeight * 4;
+    pbo.allocate(cellSize * ready.size(), GL_STREAM_DRAW);
+    for (int i = 0; i < ready.size(); i++)
+    {
+        pbo.updateData(i * cellSize, cellSize, ready[i].pixels.getData());
+    }
+    
+    GLenum target = atlas.getTextureData().textureTarget;
+    pbo.bind(GL_PIXEL_UNPACK_BUFFER);
+    glBindTexture(target, atlas.getTextureData().textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (int i = 0; i < ready.size(); i++)
+    {
+        int cell = getCell(ready[i].item);
+        int x = (cell % columns) * cellWidth;
+        int y = (cell / columns) * cellHeight;
+        glTexSubImage2D(target, 0, x, y, cellWidth, cellHeight, GL_RGBA, GL_UNSIGNED_BYTE, (const GLvoid*)(i * cellSize));
+        loaded[ready[i].item] = true;
+    }
+    glBindTexture(target, 0);
+    pbo.unbind(GL_PIXEL_UNPACK_BUFFER);
+    
+    return true;
+}
+
+void DKThumbnailAtlas::copyToCell(int item, ofFbo & fbo)
+{
+    // live thumbnails: copy a cell sized fbo straight into the atlas on the gpu
+    if (!isResident(item) || !atlas.isAllocated()) return;
+    
+    int cell = getCell(item);
+    GLenum target = atlas.getTextureData().textureTarget;
+    fbo.bind();
+    glBindTexture(target, atlas.getTextureData().textureID);
+    glCopyTexSubImage2D(target, 0, (cell % columns) * cellWidth, (cell / columns) * cellHeight, 0, 0,
+                        MIN(cellWidth, fbo.getWidth()), MIN(cellHeight, fbo.getHeight()));
+    glBindTexture(target, 0);
+    fbo.unbind();
+    loaded[item] = true;
+}
+
+bool DKThumbnailAtlas::isResident(int item)
+{
+    return item >= firstResident && item < firstResident + numResident;
+}
+
+int DKThumbnailAtlas::getCell(int item)
+{
+    return item % getCapacity();
+}
+
+bool DKThumbnailAtlas::isLoaded(int item)
+{
+    return item >= 0 && item < loaded.size() && loaded[item];
+}
+
+int DKThumbnailAtlas::getNumItems()
+{
+    return fileNames.size();
+}
+
+int DKThumbnailAtlas::getCapacity()
+{
+    return columns * rows;
+}
+
+int DKThumbnailAtlas::getCellWidth()
+{
+    return cellWidth;
+}
+
+int DKThumbnailAtlas::getCellHeight()
+{
+    return cellHeight;
+}
+
+ofTexture & DKThumbnailAtlas::getTexture()
+{
+    return atlas;
+}
+
+ofRectangle DKThumbnailAtlas::getTexCoords(int item)
+{
+    int cell = getCell(item);
+    int x = (cell % columns) * cellWidth;
+    int y = (cell / columns) * cellHeight;
+    glm::vec2 topLeft = atlas.getCoordFromPoint(x, y);
+    glm::vec2 bottomRight = atlas.getCoordFromPoint(x + cellWidth, y + cellHeight);
+    return ofRectangle(topLeft, bottomRight);
+}
+
+void DKThumbnailAtlas::addCellToMesh(ofMesh & mesh, int item, ofRectangle rect)
+{
+    ofRectangle tc = getTexCoords(item);
+    ofIndexType i = mesh.getNumVertices();
+    
+    mesh.addVertex({ rect.getLeft(), rect.getTop(), 0 });
+    mesh.addVertex({ rect.getRight(), rect.getTop(), 0 });
+    mesh.addVertex({ rect.getRight(), rect.getBottom(), 0 });
+    mesh.addVertex({ rect.getLeft(), rect.getBottom(), 0 });
+    mesh.addTexCoord({ tc.getLeft(), tc.getTop() });
+    mesh.addTexCoord({ tc.getRight(), tc.getTop() });
+    mesh.addTexCoord({ tc.getRight(), tc.getBottom() });
+    mesh.addTexCoord({ tc.getLeft(), tc.getBottom() });
+    mesh.addIndices({ i, i + 1, i + 2, i, i + 2, i + 3 });
+}
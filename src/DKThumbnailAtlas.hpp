@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2020 Luis Fernando García Pérez [http://luiscript.com]
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#ifndef DKThumbnailAtlas_hpp
+#define DKThumbnailAtlas_hpp
+
+#include "ofMain.h"
+
+// One texture holding the visible thumbnails of a media pool. Only items
+// inside the resident window are decoded, on a worker thread; update()
+// uploads whatever finished through a pixel unpack buffer, so adding items
+// never blocks on disk or decode.
+class DKThumbnailAtlas : public ofThread
+{
+public:
+    DKThumbnailAtlas();
+    ~DKThumbnailAtlas();
+    
+    int add(string);
+    void setResident(int, int);
+    bool update();
+    void copyToCell(int, ofFbo &);
+    
+    bool isLoaded(int);
+    int getNumItems();
+    int getCapacity();
+    int getCellWidth();
+    int getCellHeight();
+    ofTexture & getTexture();
+    ofRectangle getTexCoords(int);
+    
+    // appends the quad of an item to a textured triangle mesh
+    void addCellToMesh(ofMesh &, int, ofRectangle);
+    
+private:
+    struct Request
+    {
+        int item;
+        string fileName;
+    };
+    
+    struct Result
+    {
+        int item;
+        ofPixels pixels;
+    };
+    
+    void threadedFunction();
+    bool isResident(int);
+    int getCell(int);
+    
+    ofThreadChannel<Request> requests;
+    ofThreadChannel<Result> results;
+    
+    ofTexture atlas;
+    ofBufferObject pbo;
+    vector<string> fileNames;
+    vector<bool> loaded;
+    vector<bool> requested;
+    int firstResident;
+    int numResident;
+    int cellWidth;
+    int cellHeight;
+    int columns;
+    int rows;
+};
+
+#endif /* DKThumbnailAtlas_hpp */
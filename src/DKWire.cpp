@@ -28,6 +28,7 @@ DKWire::DKWire()
     input = nullptr;
     output = nullptr;
     passes = nullptr;
+    textureView = nullptr;
     
     active = true;
     
@@ -43,17 +44,21 @@ void DKWire::update()
         {
             slider->setComponentScale(*output->getScale());
         }
+        else if(getConnectionType() == DKConnectionType::DK_FBO)
+        {
+            outputModule->outputConsumed = true;
+        }
     }
 }
 
-void DKWire::draw()
+void DKWire::draw(vector<DKLineSegment> & segments, ofMesh & endpoints)
 {
     if (inputModule->getModuleEnabled() && outputModule->getModuleEnabled()) {
         float dist = getDistance();
         ofPoint p1 = output->getWireConnectionPos();
         ofPoint p2 = input->getWireConnectionPos();
         ofPoint p3 = getWireControlPoint(p1, p2, output->getDist(input));
-        drawWire(p1, p2, p3);
+        drawWire(p1, p2, p3, segments, endpoints);
     }
 }
 
@@ -66,29 +71,49 @@ ofPoint DKWire::getWireControlPoint(ofPoint p1, ofPoint p2, float dist)
 
 }
 
-void DKWire::drawWire(ofPoint p1, ofPoint p2, ofPoint p3)
+// filled circle as a triangle fan unrolled into triangles, at the
+// resolution ofDrawCircle uses by default
+static void addCircle(ofMesh & mesh, ofPoint center, float radius, ofFloatColor color)
 {
-    ofPushStyle();
-    ofPushMatrix();
-    ofNoFill();
-    ofSetLineWidth(3);
-    ofSetColor(getOutput()->getWireConnectionColor());
-    ofDrawBezier(p1.x, p1.y, p3.x, p3.y, p3.x, p3.y, p2.x, p2.y);
-    ofFill();
-    ofDrawCircle(p1.x, p1.y, connectionRadius);
-    ofDrawCircle(p2.x, p2.y, connectionRadius);
+    const int resolution = 20;
+    ofIndexType first = mesh.getNumVertices();
+    mesh.addVertex(center);
+    mesh.addColor(color);
+    for (int i = 0; i < resolution; i++)
+    {
+        float angle = TWO_PI * i / resolution;
+        mesh.addVertex({ center.x + radius * cos(angle), center.y + radius * sin(angle), 0 });
+        mesh.addColor(color);
+        mesh.addIndices({ first, first + 1 + i, first + 1 + (i + 1) % resolution });
+    }
+}
+
+// the curve is the same cubic ofDrawBezier drew, at its default resolution
+void DKWire::drawWire(ofPoint p1, ofPoint p2, ofPoint p3, vector<DKLineSegment> & segments, ofMesh & endpoints)
+{
+    ofFloatColor color = getOutput()->getWireConnectionColor();
+    const int resolution = 20;
+    glm::vec3 last = p1;
+    for (int i = 1; i <= resolution; i++)
+    {
+        float t = (float) i / resolution;
+        float u = 1 - t;
+        glm::vec3 point = u * u * u * p1 + 3 * u * t * p3 + t * t * t * p2;
+        segments.push_back({ last, point, color });
+        last = point;
+    }
     
-    ofPopMatrix();
-    ofPopStyle();
+    addCircle(endpoints, p1, connectionRadius, color);
+    addCircle(endpoints, p2, connectionRadius, color);
 }
 
-void DKWire::drawCurrentWire(ofPoint p)
+void DKWire::drawCurrentWire(ofPoint p, vector<DKLineSegment> & segments, ofMesh & endpoints)
 {
     ofPoint op = output->getWireConnectionPos();
     float dist = ofDist(op.x, op.y, p.x, p.y);
     ofPoint out = output->getWireConnectionPos();
     ofPoint controlPoint = getWireControlPoint(out, p, dist);
-    drawWire(out, p, controlPoint);
+    drawWire(out, p, controlPoint, segments, endpoints);
 }
 
 DKWireConnection * DKWire::getInput()
@@ -32,9 +32,11 @@ public:
     
     void update();
 
-    void draw();
-    void drawCurrentWire(ofPoint);
-    void drawWire(ofPoint, ofPoint, ofPoint);
+    // the curves are appended as segments and the endpoint dots as triangles,
+    // the caller draws the segments and then the dots on top, one call each
+    void draw(vector<DKLineSegment> &, ofMesh &);
+    void drawCurrentWire(ofPoint, vector<DKLineSegment> &, ofMesh &);
+    void drawWire(ofPoint, ofPoint, ofPoint, vector<DKLineSegment> &, ofMesh &);
     
     float getDistance();
     ofPoint getWireControlPoint(ofPoint, ofPoint, float);
@@ -58,6 +60,7 @@ public:
     void * data;
     ofFbo * fbo;
 	ofLight* light;
+    DKTextureView* textureView;
     //DKFboChain* chain;
     vector<DKModule*>* passes;
     double * scale;
@@ -138,6 +138,16 @@ void DKWireConnection::setLight(ofLight* l)
 	light = l;
 }
 
+DKTextureView* DKWireConnection::getTextureView()
+{
+    return textureView;
+}
+
+void DKWireConnection::setTextureView(DKTextureView* view)
+{
+    textureView = view;
+}
+
 ofColor DKWireConnection::getWireConnectionColor()
 {
 	if (connectionType == DKConnectionType::DK_FBO
@@ -145,4 +155,6 @@ ofColor DKWireConnection::getWireConnectionColor()
 	if (connectionType == DKConnectionType::DK_SLIDER) return ofColor(255, 255, 255);
 	if (connectionType == DKConnectionType::DK_LIGHT) return ofColor(0, 180, 180);
     if (connectionType == DKConnectionType::DK_CHAIN) return ofColor(226, 88, 33);
+    if (connectionType == DKConnectionType::DK_TEXTURE) return ofColor(180, 90, 180);
+    return ofColor(255, 255, 255);
 }
@@ -42,6 +42,13 @@ struct DKFboChain
     ofFbo* writeFbo;
 };
 
+// a region of an fbo passed down DK_TEXTURE wires, consumers sample it in place
+struct DKTextureView
+{
+    ofFbo* fbo;
+    ofRectangle region;
+};
+
 
 class DKWireConnection{
 private:
@@ -51,6 +58,7 @@ private:
     double * scale;
     ofFbo * fboPtr;
 	ofLight* light;
+    DKTextureView* textureView = nullptr;
     unsigned connectionIndex = 0;
 public:
     void setup(ofPoint, string);
@@ -81,6 +89,9 @@ public:
 
 	ofLight* getLight();
 	void setLight(ofLight*);
+
+    DKTextureView* getTextureView();
+    void setTextureView(DKTextureView*);
 };
 
 
@@ -35,6 +35,7 @@ ofxDarkKnight::~ofxDarkKnight()
 void ofxDarkKnight::setup()
 {
     loadWires = shiftKey = altKey = cmdKey = midiMapMode = drawing = showExplorer = false;
+    midiDispatchDirty = true;
     translation = { 0, 0 };
     resolution = { 1920, 1080 };
 	zoom = 1.0;
@@ -57,6 +58,7 @@ void ofxDarkKnight::setup()
     for(auto it = poolNames.begin(); it != poolNames.end(); it++) componentsList->add(*it);
 
     ofAddListener(ofEvents().mousePressed,  this, &ofxDarkKnight::handleMousePressed);
+    ofAddListener(ofEvents().mouseMoved,    this, &ofxDarkKnight::handleMouseMoved);
     ofAddListener(ofEvents().mouseDragged,  this, &ofxDarkKnight::handleMouseDragged);
     ofAddListener(ofEvents().mouseScrolled, this, &ofxDarkKnight::handleMouseScrolled);
 	ofAddListener(ofEvents().mouseReleased, this, &ofxDarkKnight::handleMouseReleased);
@@ -73,12 +75,30 @@ void ofxDarkKnight::setup()
 	}
 	#endif
 	addModule("PROJECT");
-
+    
+    wireLines.setup();
 }
  
 
 void ofxDarkKnight::update()
 {
+    DKGLState::invalidate();
+    
+    for(auto m : addedChildModules) addChildModule(m);
+    addedChildModules.clear();
+    for(auto m : deletedChildModules) deleteChildModule(m);
+    deletedChildModules.clear();
+    
+    //pools build and evict canvases on this thread, midi is handled here too
+    ofxMidiMessage msg;
+    while(midiMessages.tryReceive(msg)) handleMidiMessage(msg);
+    
+    //cues switch all of their pools and sliders here, before any module updates
+    cues.apply();
+    
+    //lfo outputs are sampled now so the wires below carry this moment's phase
+    DKLfoEngine::get().evaluate();
+    
     for (auto wire : wires)
         if(wire.inputModule->getModuleEnabled() &&
            wire.outputModule->getModuleEnabled())
@@ -107,9 +127,26 @@ void ofxDarkKnight::draw()
     ofTranslate(translation.x, translation.y);
 	ofScale(zoom);
     
-    if(drawing) currentWire->drawCurrentWire(pointer);
+    DKGLState::invalidate();
     
-    for(auto wire : wires) wire.draw();
+    ofPushStyle();
+    wireSegments.clear();
+    wireEndpoints.clear();
+    wireEndpoints.setMode(OF_PRIMITIVE_TRIANGLES);
+    if(drawing) currentWire->drawCurrentWire(pointer, wireSegments, wireEndpoints);
+    for(auto & wire : wires) wire.draw(wireSegments, wireEndpoints);
+    //all the curves in one draw, each segment carries its wire's color,
+    //then the connection dots on top of them in another
+    wireLines.write(wireSegments);
+    ofSetColor(255);
+    wireLines.draw(3);
+    if(wireEndpoints.getNumVertices() > 0)
+    {
+        ofFill();
+        wireEndpoints.draw();
+    }
+    ofPopStyle();
+    DKGLState::invalidate();
     
     for(auto module : modules )
         if(!module.second->moduleIsChild && module.second->getModuleEnabled())
@@ -130,6 +167,7 @@ void ofxDarkKnight::toggleList()
 void ofxDarkKnight::toggleMappingMode()
 {
     midiMapMode = !midiMapMode;
+    midiDispatchDirty = true;
     
     for(pair<string, DKModule*> module : modules )
     {
@@ -176,6 +214,19 @@ void ofxDarkKnight::handleKeyPressed(ofKeyEventArgs& keyboard)
 		savePreset();
 	}
 
+	//cmd + shift + 'c' capture a cue, in map mode the next note on is learned for it
+	if (shiftKey && cmdKey && keyboard.keycode == 67 && !keyboard.isRepeat)
+	{
+		cues.capture("cue " + ofToString(cues.getNumCues() + 1), modules);
+		if (midiMapMode) cues.armLearn();
+	}
+
+	//cmd + 'g' go to the next cue
+	if (cmdKey && !shiftKey && keyboard.keycode == 71 && !keyboard.isRepeat)
+	{
+		cues.triggerNext();
+	}
+
 	//cmd + r reset translation and zoom
 	if (cmdKey && keyboard.keycode == 82)
 	{
@@ -231,6 +282,19 @@ void ofxDarkKnight::handleMousePressed(ofMouseEventArgs &mouse)
 
 }
 
+void ofxDarkKnight::handleMouseMoved(ofMouseEventArgs &mouse)
+{
+    //hovering a media pool cell warms that canvas up before it gets clicked
+    for(pair<string, DKModule*> module : modules )
+    {
+        if(module.second->getModuleHasChild() && module.second->getModuleEnabled())
+        {
+            DKMediaPool * mp = static_cast<DKMediaPool*>(module.second);
+            mp->mouseMoved(mouse);
+        }
+    }
+}
+
 void ofxDarkKnight::handleMouseDragged(ofMouseEventArgs & mouse)
 {
 	if (shiftKey)
@@ -274,6 +338,18 @@ void ofxDarkKnight::handleMouseScrolled(ofMouseEventArgs & mouse)
 			zoom = 0.15;
 		}
 	}
+	else
+	{
+		//scrolling over a media pool flips its pages
+		for(pair<string, DKModule*> module : modules )
+		{
+			if(module.second->getModuleHasChild() && module.second->getModuleEnabled())
+			{
+				DKMediaPool * mp = static_cast<DKMediaPool*>(module.second);
+				mp->mouseScrolled(mouse);
+			}
+		}
+	}
 }
 
 void ofxDarkKnight::checkOutputConnection(float x, float y, string moduleName)
@@ -305,6 +381,11 @@ void ofxDarkKnight::checkOutputConnection(float x, float y, string moduleName)
 				output->setLight(module.second->getLight());
 				currentWire->light = module.second->getLight();
 			}
+			else if (currentWireConnectionType == DKConnectionType::DK_TEXTURE)
+			{
+				output->setTextureView(module.second->getTextureView());
+				currentWire->textureView = module.second->getTextureView();
+			}
 
             pointer.x = x;
             pointer.y = y;
@@ -347,6 +428,12 @@ void ofxDarkKnight::checkOutputConnection(float x, float y, string moduleName)
 						it->inputModule->setLight(nullptr);
 						currentWire->light = it->output->getLight();
 					}
+					else if (currentWire->getConnectionType() == DKConnectionType::DK_TEXTURE)
+					{
+						input->setTextureView(nullptr);
+						it->inputModule->setTextureView(nullptr);
+						currentWire->textureView = it->outputModule->getTextureView();
+					}
                     else if (currentWire->getConnectionType() == DKConnectionType::DK_CHAIN)
                     {
                         currentWire->outputModule->setChainModule(nullptr);
@@ -412,6 +499,11 @@ void ofxDarkKnight::checkInputConnection(float x, float y, string moduleName)
 				module.second->getInputConnection(x, y)->setLight(currentWire->light);
 				module.second->setLight(currentWire->light);
 			}
+			else if (currentWire->getConnectionType() == DKConnectionType::DK_TEXTURE)
+			{
+				module.second->getInputConnection(x, y)->setTextureView(currentWire->textureView);
+				module.second->setTextureView(currentWire->textureView);
+			}
             else if (currentWire->getConnectionType() == DKConnectionType::DK_CHAIN)
             {
                 currentWire->outputModule->setChainModule(module.second);
@@ -486,6 +578,7 @@ void ofxDarkKnight::handleDragEvent(ofDragInfo & dragInfo)
 
 void ofxDarkKnight::addModule(string moduleName, DKModule * module)
 {
+    midiDispatchDirty = true;
     module->setModuleMidiMapMode(midiMapMode);
 	module->setModuleId(getNextModuleId());
     modules.insert({moduleName, module});
@@ -495,6 +588,7 @@ DKModule * ofxDarkKnight::addModule(string moduleName)
 {
 	int moduleId = getNextModuleId();
 	string uniqueModuleName = moduleName + "@" + ofToString(moduleId);
+    midiDispatchDirty = true;
 	
 	auto newModule = moduleList[moduleName]();
     newModule->setupModule(moduleName, resolution);
@@ -534,19 +628,16 @@ DKModule * ofxDarkKnight::addModule(string moduleName)
         DKMediaPool * mp = static_cast<DKMediaPool*>(newModule);
         mp->setModulesReference(&modules);
         mp->setTranslationReferences(&translation, &zoom);
-        int mIndex = 0;
-        for(CollectionItem item : mp->collection)
+        for(CollectionItem & item : mp->collection)
         {
+            //lazy items that weren't built yet are announced later through addModule
             DKModule * m = item.canvas;
-            if(mIndex > 0) m->disable();
-            string childName = m->getName();
-            m->setModuleMidiMapMode(midiMapMode);
-			int childModuleId = getNextModuleId();
-			m->setModuleId(childModuleId);
-			string childNameWithId = childName + "@" + ofToString(childModuleId);
-            modules.insert({childNameWithId, m}); 
-            mIndex ++;
+            if(m == nullptr) continue;
+            if(m != mp->getChildModule()) m->disable();
+            addChildModule(m);
         }
+        ofAddListener(mp->addModule, this, &ofxDarkKnight::onChildModuleAdded);
+        ofAddListener(mp->deleteModule, this, &ofxDarkKnight::onChildModuleDeleted);
 
     }
     return newModule;
@@ -557,6 +648,60 @@ void ofxDarkKnight::deleteModule(string moduleName)
     modules.erase(moduleName);
 }
 
+void ofxDarkKnight::addChildModule(DKModule * m)
+{
+    m->setModuleMidiMapMode(midiMapMode);
+    int childModuleId = getNextModuleId();
+    m->setModuleId(childModuleId);
+    string childNameWithId = m->getName() + "@" + ofToString(childModuleId);
+    modules.insert({childNameWithId, m});
+    midiDispatchDirty = true;
+}
+
+//media pools build and evict canvases while modules is being iterated,
+//so both are queued and applied at the start of the next update
+void ofxDarkKnight::onChildModuleAdded(DKModule *& m)
+{
+    addedChildModules.push_back(m);
+}
+
+void ofxDarkKnight::onChildModuleDeleted(DKModule *& m)
+{
+    deletedChildModules.push_back(m);
+}
+
+void ofxDarkKnight::deleteChildModule(DKModule * m)
+{
+    vector<DKWire>::iterator itw = wires.begin();
+    while(itw != wires.end())
+    {
+        if(m == itw->outputModule || m == itw->inputModule)
+        {
+            itw = wires.erase(itw);
+        } else {
+            itw++;
+        }
+    }
+    
+    for(auto it = modules.begin(); it != modules.end(); it++)
+    {
+        if(it->second == m)
+        {
+            modules.erase(it);
+            break;
+        }
+    }
+    
+    cues.remove(m);
+    m->inputs.clear();
+    m->outputs.clear();
+    m->gui->deleteItems();
+    m->unMount();
+    delete m->gui;
+    delete m;
+    midiDispatchDirty = true;
+}
+
 //delete wires connected to focused component and then delete the component
 void ofxDarkKnight::deleteFocusedModule()
 {
@@ -598,11 +743,13 @@ void ofxDarkKnight::deleteFocusedModule()
                 }
             }
             // now that we deleted all the module's wires procede to unmount and delete the module it self
+            cues.remove(module.second);
             module.second->inputs.clear();
             module.second->outputs.clear();
             module.second->gui->deleteItems();
             modules.erase(module.first);
             module.second->unMount();
+            midiDispatchDirty = true;
             break;
         }
     }
@@ -619,6 +766,8 @@ void ofxDarkKnight::deleteAllModules()
 	}
 
 	modules.clear();
+	cues.clear();
+	midiDispatchDirty = true;
 }
 
 void ofxDarkKnight::deleteComponentWires(ofxDatGuiComponent * component, int deletedModuleId)
@@ -661,31 +810,65 @@ void ofxDarkKnight::close()
 
 void ofxDarkKnight::newMidiMessage(ofxMidiMessage & msg)
 {
+    midiMessages.send(msg);
+}
+
+void ofxDarkKnight::handleMidiMessage(ofxMidiMessage & msg)
+{
+    if(midiDispatchDirty) compileMidiDispatch();
+    
     //send midi message to media pool.
+    for(auto mp : midiDispatch.getPools()) mp->gotMidiMessage(&msg);
+    
+    if(midiMapMode)
+    {
+        //midi learn: note on maps pool items, control change maps the selected sliders
+        int key = DKMidiDispatch::pack(msg);
+        if(msg.status == MIDI_NOTE_ON && msg.velocity > 0 && cues.isLearning())
+        {
+            cues.learn(key);
+            midiDispatchDirty = true;
+            return;
+        }
+        for(pair<string, DKModule*> module : modules )
+        {
+            if(msg.status == MIDI_NOTE_ON && msg.velocity > 0 && module.second->getModuleHasChild())
+            {
+                DKMediaPool * mp = static_cast<DKMediaPool*>(module.second);
+                if(mp->learnMidiMapping(key)) midiDispatchDirty = true;
+            }
+            else if(msg.status == MIDI_CONTROL_CHANGE)
+            {
+                if(module.second->setMidiMapping(key)) midiDispatchDirty = true;
+            }
+        }
+        return;
+    }
+    
+    midiDispatch.dispatch(msg);
+}
+
+//flatten every midi-learn binding into the dispatch table, only runs after mappings or modules changed
+void ofxDarkKnight::compileMidiDispatch()
+{
+    midiDispatch.clear();
     for(pair<string, DKModule*> module : modules )
+    {
+        for(auto & mapping : module.second->getMidiMappings())
+            midiDispatch.addSlider(mapping.first, mapping.second);
+        
         if(module.second->getModuleHasChild())
         {
             DKMediaPool * mp = static_cast<DKMediaPool*>(module.second);
-            mp->gotMidiMessage(&msg);
+            midiDispatch.addPool(mp);
+            for(auto & mapping : mp->midiMappings)
+                midiDispatch.addPoolTrigger(mapping.first, mp, mapping.second);
         }
-    
-    string mapping;
-    if(msg.control > 0)
-    {
-        mapping = ofToString(msg.channel) + "/"
-                + ofToString(msg.control);
-    } else {
-        mapping = ofToString(msg.channel) + "/"
-                + ofToString(msg.pitch);
-
-        if(msg.status == MIDI_NOTE_ON)
-            for(pair<string, DKModule*> module : modules )
-                if(module.second->getModuleHasChild())
-                {
-                    DKMediaPool * mp = static_cast<DKMediaPool*>(module.second);
-                    mp->gotMidiMapping(mapping);
-                }
     }
+    for(auto & mapping : cues.midiMappings)
+        midiDispatch.addCueTrigger(mapping.first, &cues, mapping.second);
+    midiDispatch.build();
+    midiDispatchDirty = false;
 }
 
 void ofxDarkKnight::sendMidiMessage(ofxMidiMessage & msg)
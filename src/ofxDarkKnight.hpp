@@ -58,6 +58,19 @@ private:
     
     DKWire* currentWire;
     vector<DKWire> wires;
+    vector<DKLineSegment> wireSegments;
+    DKLineRenderer wireLines;
+    ofMesh wireEndpoints;
+    
+    DKMidiDispatch midiDispatch;
+    bool midiDispatchDirty;
+    // filled on the midi thread, drained on the main thread in update
+    ofThreadChannel<ofxMidiMessage> midiMessages;
+    
+    DKCueList cues;
+    
+    vector<DKModule*> addedChildModules;
+    vector<DKModule*> deletedChildModules;
     
     ofxDatGui* gui;
     ofxDatGuiScrollView* componentsList;
@@ -92,8 +105,14 @@ public:
     void deleteFocusedModule();
 	void deleteAllModules();
     
+    void addChildModule(DKModule *);
+    void deleteChildModule(DKModule *);
+    void onChildModuleAdded(DKModule *&);
+    void onChildModuleDeleted(DKModule *&);
+    
     //mouse event handlers
     void handleMousePressed(ofMouseEventArgs&);
+    void handleMouseMoved(ofMouseEventArgs&);
     void handleMouseDragged(ofMouseEventArgs&);
     void handleMouseReleased(ofMouseEventArgs&);
 
@@ -106,6 +125,8 @@ public:
     void onResolutionChange(ofVec2f &);
     void onComponentListChange(ofxDatGuiScrollViewEvent e);
     void newMidiMessage(ofxMidiMessage &);
+    void handleMidiMessage(ofxMidiMessage &);
+    void compileMidiDispatch();
     
     void savePreset();
     